@@ -0,0 +1,241 @@
+#include "bench.hpp"
+#include <proto/proto.hpp>
+#include <functional>
+#include <memory>
+
+// Compares proto::signal with the observer patterns it replaces when they
+// are written by hand, for emission, connection and disconnection.
+
+namespace {
+
+	int counter = 0;
+
+	struct observer_interface {
+		virtual ~observer_interface() = default;
+		virtual void notify(int x) = 0;
+	};
+
+	// the receiving end of every slot, only the virtual observer list
+	// calls notify
+	struct weighted_observer : observer_interface {
+		int weight = 1;
+
+		void notify(int x) override {
+			counter += weight * x;
+		}
+	};
+
+	// Every implementation connects an observer, disconnects it again by
+	// the handle connect returned, and emits to all connected observers.
+
+	class proto_signal {
+	public:
+		using handle = proto::connection;
+
+		handle connect(weighted_observer& observer) {
+			return m_signal.connect([&observer](int x) { counter += observer.weight * x; });
+		}
+
+		void disconnect(handle& conn) {
+			conn.close();
+		}
+
+		void emit(int x) {
+			m_signal.emit(x);
+		}
+
+	private:
+		proto::signal<void(int)> m_signal;
+	};
+
+	// a vector of std::function, disconnected by an id that is looked up
+	class function_list {
+	public:
+		using handle = uint64_t;
+
+		handle connect(weighted_observer& observer) {
+			m_slots.emplace_back(m_next_id, [&observer](int x) { counter += observer.weight * x; });
+			return m_next_id++;
+		}
+
+		void disconnect(handle id) {
+			for (auto it = m_slots.begin(); it != m_slots.end(); ++it) {
+				if (it->first == id) {
+					m_slots.erase(it);
+					return;
+				}
+			}
+		}
+
+		void emit(int x) {
+			for (auto& slot : m_slots)
+				slot.second(x);
+		}
+
+	private:
+		std::vector<std::pair<uint64_t, std::function<void(int)>>> m_slots;
+		uint64_t m_next_id = 0;
+	};
+
+	// a vector of plain function pointers with a context each,
+	// disconnected by the context
+	class function_pointer_list {
+	public:
+		using handle = void*;
+
+		handle connect(weighted_observer& observer) {
+			m_slots.push_back({ &notify, &observer });
+			return &observer;
+		}
+
+		void disconnect(handle context) {
+			for (auto it = m_slots.begin(); it != m_slots.end(); ++it) {
+				if (it->context == context) {
+					m_slots.erase(it);
+					return;
+				}
+			}
+		}
+
+		void emit(int x) {
+			for (const slot& s : m_slots)
+				s.function(s.context, x);
+		}
+
+	private:
+		struct slot {
+			void(*function)(void*, int);
+			void* context;
+		};
+
+		static void notify(void* context, int x) {
+			counter += static_cast<weighted_observer*>(context)->weight * x;
+		}
+
+		std::vector<slot> m_slots;
+	};
+
+	// a vector of observer interfaces called through virtual functions
+	class virtual_observer_list {
+	public:
+		using handle = observer_interface*;
+
+		handle connect(weighted_observer& observer) {
+			m_observers.push_back(&observer);
+			return &observer;
+		}
+
+		void disconnect(handle observer) {
+			for (auto it = m_observers.begin(); it != m_observers.end(); ++it) {
+				if (*it == observer) {
+					m_observers.erase(it);
+					return;
+				}
+			}
+		}
+
+		void emit(int x) {
+			for (observer_interface* observer : m_observers)
+				observer->notify(x);
+		}
+
+	private:
+		std::vector<observer_interface*> m_observers;
+	};
+
+	template <class Impl>
+	bench::result emit(const std::string& name, size_t num_slots) {
+		std::vector<weighted_observer> observers(num_slots);
+		Impl impl;
+		std::vector<typename Impl::handle> handles;
+		for (weighted_observer& observer : observers)
+			handles.push_back(impl.connect(observer));
+
+		return bench::measure("emit/" + name + "/" + std::to_string(num_slots), [&] {
+			impl.emit(1);
+			bench::do_not_optimize(counter);
+		});
+	}
+
+	// connects num_slots observers to a new instance
+	template <class Impl>
+	bench::result connect(const std::string& name, size_t num_slots) {
+		std::vector<weighted_observer> observers(num_slots);
+		std::vector<typename Impl::handle> handles;
+		handles.reserve(num_slots);
+
+		return bench::measure("connect/" + name + "/" + std::to_string(num_slots), [&] {
+			Impl impl;
+			for (weighted_observer& observer : observers)
+				handles.push_back(impl.connect(observer));
+			bench::do_not_optimize(handles.data());
+			handles.clear();
+		});
+	}
+
+	// connects num_slots observers to a new instance and disconnects them
+	// in the order they were connected
+	template <class Impl>
+	bench::result connect_disconnect(const std::string& name, size_t num_slots) {
+		std::vector<weighted_observer> observers(num_slots);
+		std::vector<typename Impl::handle> handles;
+		handles.reserve(num_slots);
+
+		return bench::measure("connect_disconnect/" + name + "/" + std::to_string(num_slots), [&] {
+			Impl impl;
+			for (weighted_observer& observer : observers)
+				handles.push_back(impl.connect(observer));
+			for (auto& handle : handles)
+				impl.disconnect(handle);
+			bench::do_not_optimize(handles.data());
+			handles.clear();
+		});
+	}
+
+	template <template <class> class Scenario>
+	void compare(std::vector<bench::result>& results, size_t num_slots) {
+		results.push_back(Scenario<proto_signal>::run("proto_signal", num_slots));
+		results.push_back(Scenario<function_list>::run("std_function", num_slots));
+		results.push_back(Scenario<function_pointer_list>::run("function_pointer", num_slots));
+		results.push_back(Scenario<virtual_observer_list>::run("virtual_observer", num_slots));
+	}
+
+	template <class Impl>
+	struct emit_scenario {
+		static bench::result run(const std::string& name, size_t num_slots) { return emit<Impl>(name, num_slots); }
+	};
+
+	template <class Impl>
+	struct connect_scenario {
+		static bench::result run(const std::string& name, size_t num_slots) { return connect<Impl>(name, num_slots); }
+	};
+
+	template <class Impl>
+	struct connect_disconnect_scenario {
+		static bench::result run(const std::string& name, size_t num_slots) { return connect_disconnect<Impl>(name, num_slots); }
+	};
+
+	// prints the time proto takes relative to each hand written pattern,
+	// the results come in groups of four in the order of compare
+	void print_ratios(const std::vector<bench::result>& results) {
+		std::printf("\n%-40s %14s %18s %18s\n", "proto_signal relative to", "std_function", "function_pointer", "virtual_observer");
+		for (size_t i = 0; i + 3 < results.size(); i += 4) {
+			const double ns = results[i].ns_per_op;
+			std::printf("%-40s %14.2f %18.2f %18.2f\n", results[i].name.c_str(),
+				ns / results[i + 1].ns_per_op, ns / results[i + 2].ns_per_op, ns / results[i + 3].ns_per_op);
+		}
+	}
+
+}
+
+int main(int argc, char** argv) {
+	std::vector<bench::result> results;
+	for (size_t num_slots : { 1, 8, 64, 500, 5000 }) {
+		compare<emit_scenario>(results, num_slots);
+		compare<connect_scenario>(results, num_slots);
+		compare<connect_disconnect_scenario>(results, num_slots);
+	}
+	const int status = bench::report(results, argc, argv);
+	print_ratios(results);
+	return status;
+}
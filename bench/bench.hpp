@@ -0,0 +1,406 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <utility>
+
+#include <limits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace bench {
+
+	// prevents the compiler from optimizing away the computation of value
+	template <class T>
+	inline void do_not_optimize(const T& value) {
+#if defined(_MSC_VER)
+		static volatile const void* sink;
+		sink = &value;
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	// the hardware events counted per operation
+	enum class event {
+		cycles,
+		instructions,
+		l1d_misses,
+		llc_misses,
+		branch_misses
+	};
+
+	inline constexpr size_t num_events = 5;
+	inline constexpr const char* event_names[num_events] = {
+		"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"
+	};
+
+	using event_counts = std::array<double, num_events>;
+
+	// NaN marks events that could not be counted
+	inline event_counts no_events() {
+		event_counts counts;
+		counts.fill(std::numeric_limits<double>::quiet_NaN());
+		return counts;
+	}
+
+	// Counts the hardware events in user space for the calling thread 
+	// through perf_event_open, as one group so that they cover the same 
+	// instructions. Events are invalid where they are unavailable, such as
+	// in most containers and virtual machines, and all of them are on 
+	// platforms other than Linux.
+	class hardware_counters {
+	public:
+		hardware_counters() {
+#if defined(__linux__)
+			const std::pair<uint32_t, uint64_t> configs[num_events] = {
+				{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+				{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+				{ PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D 
+					| (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+				{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+				{ PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+			};
+			for (size_t i = 0; i < num_events; ++i) {
+				perf_event_attr attr = {};
+				attr.size = sizeof(attr);
+				attr.type = configs[i].first;
+				attr.config = configs[i].second;
+				// the first event that opens leads the group
+				attr.disabled = m_leader < 0;
+				attr.exclude_kernel = 1;
+				attr.exclude_hv = 1;
+				m_fds[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, m_leader, 0));
+				if (m_leader < 0)
+					m_leader = m_fds[i];
+			}
+#endif
+		}
+
+		hardware_counters(const hardware_counters&) = delete;
+		hardware_counters& operator=(const hardware_counters&) = delete;
+
+		~hardware_counters() {
+#if defined(__linux__)
+			for (int fd : m_fds)
+				if (fd >= 0)
+					::close(fd);
+#endif
+		}
+
+		bool valid() const noexcept {
+			return m_leader >= 0;
+		}
+
+		bool valid(event e) const noexcept {
+			return m_fds[size_t(e)] >= 0;
+		}
+
+		void start() noexcept {
+#if defined(__linux__)
+			if (valid()) {
+				::ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+				::ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+			}
+#endif
+		}
+
+		// returns the number of each event since start, NaN for the
+		// events that are unavailable
+		event_counts stop() noexcept {
+			event_counts counts = no_events();
+#if defined(__linux__)
+			if (valid()) {
+				::ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+				for (size_t i = 0; i < num_events; ++i) {
+					uint64_t count = 0;
+					if (m_fds[i] >= 0 && ::read(m_fds[i], &count, sizeof(count)) == sizeof(count))
+						counts[i] = double(count);
+				}
+			}
+#endif
+			return counts;
+		}
+
+	private:
+		int m_fds[num_events] = { -1, -1, -1, -1, -1 };
+		int m_leader = -1;
+	};
+
+	struct result {
+		std::string name;
+		uint64_t iterations;
+		double ns_per_op;
+		event_counts events_per_op = no_events();
+	};
+
+	// Runs op in batches whose size is calibrated to take roughly min_time,
+	// and reports the fastest of the batches.
+	template <class Op>
+	result measure(std::string name, Op&& op,
+		std::chrono::nanoseconds min_time = std::chrono::milliseconds(50), int num_batches = 5) 
+	{
+		using clock = std::chrono::steady_clock;
+
+		hardware_counters counters;
+
+		auto run = [&](uint64_t iterations) {
+			auto start = clock::now();
+			for (uint64_t i = 0; i < iterations; ++i)
+				op();
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start);
+		};
+
+		uint64_t iterations = 1;
+		for (auto elapsed = run(iterations); elapsed < min_time; elapsed = run(iterations))
+			iterations *= 2;
+
+		result best{ std::move(name), iterations, 0 };
+		for (int i = 0; i < num_batches; ++i) {
+			counters.start();
+			double ns_per_op = double(run(iterations).count()) / double(iterations);
+			event_counts counts = counters.stop();
+			if (i == 0 || ns_per_op < best.ns_per_op) {
+				best.ns_per_op = ns_per_op;
+				for (size_t j = 0; j < num_events; ++j)
+					best.events_per_op[j] = counts[j] / double(iterations);
+			}
+		}
+		return best;
+	}
+
+	// Runs op(thread_index) iterations times on each of num_threads threads
+	// at once and reports the wall time per operation across all threads.
+	template <class Op>
+	result measure_threads(std::string name, size_t num_threads, uint64_t iterations, Op&& op) {
+		using clock = std::chrono::steady_clock;
+
+		std::atomic<size_t> num_ready{ 0 };
+		std::atomic<bool> start{ false };
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < num_threads; ++i) {
+			threads.emplace_back([&, i] {
+				++num_ready;
+				while (!start.load(std::memory_order_acquire))
+					std::this_thread::yield();
+				for (uint64_t j = 0; j < iterations; ++j)
+					op(i);
+			});
+		}
+
+		while (num_ready.load() != num_threads)
+			std::this_thread::yield();
+		auto begin = clock::now();
+		start.store(true, std::memory_order_release);
+		for (std::thread& thread : threads)
+			thread.join();
+		auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - begin);
+
+		uint64_t total = iterations * num_threads;
+		return { std::move(name), total, double(elapsed.count()) / double(total) };
+	}
+
+	// Counts values in logarithmic buckets that are split into 32 linear
+	// sub buckets each, which bounds the error of reported percentiles by
+	// about 3% and never allocates while recording.
+	class histogram {
+	public:
+		void record(uint64_t value) noexcept {
+			++m_counts[bucket(value)];
+			++m_count;
+			m_max = value > m_max ? value : m_max;
+		}
+
+		uint64_t count() const noexcept {
+			return m_count;
+		}
+
+		uint64_t max() const noexcept {
+			return m_max;
+		}
+
+		// the upper bound of the bucket that holds the value below which 
+		// fraction of the recorded values fall, capped at the maximum
+		uint64_t percentile(double fraction) const noexcept {
+			const uint64_t rank = static_cast<uint64_t>(fraction * double(m_count));
+			uint64_t seen = 0;
+			for (size_t i = 0; i < num_buckets; ++i) {
+				seen += m_counts[i];
+				if (seen > rank) {
+					const uint64_t upper = upper_bound(i);
+					return upper < m_max ? upper : m_max;
+				}
+			}
+			return m_max;
+		}
+
+	private:
+		static constexpr int sub_bits = 5;
+		static constexpr uint64_t num_sub_buckets = uint64_t(1) << sub_bits;
+		static constexpr size_t num_buckets = (64 - sub_bits + 1) * num_sub_buckets;
+
+		static int log2(uint64_t value) noexcept {
+#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanReverse64(&index, value);
+			return int(index);
+#else
+			return 63 - __builtin_clzll(value);
+#endif
+		}
+
+		static size_t bucket(uint64_t value) noexcept {
+			if (value < num_sub_buckets)
+				return size_t(value);
+			const int shift = log2(value) - sub_bits;
+			return size_t(shift + 1) * num_sub_buckets + size_t((value >> shift) & (num_sub_buckets - 1));
+		}
+
+		static uint64_t upper_bound(size_t index) noexcept {
+			if (index < num_sub_buckets)
+				return index;
+			const int shift = int(index / num_sub_buckets) - 1;
+			const uint64_t lower = (num_sub_buckets + index % num_sub_buckets) << shift;
+			return lower + ((uint64_t(1) << shift) - 1);
+		}
+
+		uint64_t m_counts[num_buckets] = {};
+		uint64_t m_count = 0;
+		uint64_t m_max = 0;
+	};
+
+	struct latency_result {
+		std::string name;
+		histogram latencies;
+	};
+
+	inline void print(const std::vector<latency_result>& results) {
+		size_t width = 4;
+		for (const latency_result& r : results)
+			width = std::max(width, r.name.size());
+
+		std::printf("%-*s %12s %10s %10s %10s %12s\n", int(width), "name", "samples", "p50 ns", "p99 ns", "p99.9 ns", "max ns");
+		for (const latency_result& r : results) {
+			std::printf("%-*s %12llu %10llu %10llu %10llu %12llu\n", int(width), r.name.c_str(),
+				static_cast<unsigned long long>(r.latencies.count()),
+				static_cast<unsigned long long>(r.latencies.percentile(0.5)),
+				static_cast<unsigned long long>(r.latencies.percentile(0.99)),
+				static_cast<unsigned long long>(r.latencies.percentile(0.999)),
+				static_cast<unsigned long long>(r.latencies.max()));
+		}
+	}
+
+	inline void print(const std::vector<result>& results) {
+		size_t width = 4;
+		for (const result& r : results)
+			width = std::max(width, r.name.size());
+
+		std::printf("%-*s %14s %12s", int(width), "name", "iterations", "ns/op");
+		for (const char* event_name : event_names)
+			std::printf(" %14s", event_name);
+		std::printf("\n");
+		for (const result& r : results) {
+			std::printf("%-*s %14llu %12.2f", int(width), r.name.c_str(),
+				static_cast<unsigned long long>(r.iterations), r.ns_per_op);
+			for (double count : r.events_per_op) {
+				if (count == count)
+					std::printf(" %14.3f", count);
+				else
+					std::printf(" %14s", "-");
+			}
+			std::printf("\n");
+		}
+	}
+
+	// escapes name for a JSON string
+	inline std::string json_escape(const std::string& name) {
+		std::string escaped;
+		for (char c : name) {
+			if (c == '"' || c == '\\')
+				escaped += '\\';
+			escaped += c;
+		}
+		return escaped;
+	}
+
+	// writes the results as a JSON array of objects that hold the name,
+	// iterations, ns_per_op and the count of each event per operation, 
+	// which is null where the event is unavailable
+	inline bool write_json(const std::vector<result>& results, const std::string& path) {
+		std::FILE* file = std::fopen(path.c_str(), "w");
+		if (!file)
+			return false;
+		std::fprintf(file, "[\n");
+		for (size_t i = 0; i < results.size(); ++i) {
+			const result& r = results[i];
+			const std::string name = json_escape(r.name);
+			std::fprintf(file, "  { \"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f", 
+				name.c_str(), static_cast<unsigned long long>(r.iterations), r.ns_per_op);
+			for (size_t j = 0; j < num_events; ++j) {
+				if (r.events_per_op[j] == r.events_per_op[j])
+					std::fprintf(file, ", \"%s\": %.4f", event_names[j], r.events_per_op[j]);
+				else
+					std::fprintf(file, ", \"%s\": null", event_names[j]);
+			}
+			std::fprintf(file, " }%s\n", i + 1 < results.size() ? "," : "");
+		}
+		std::fprintf(file, "]\n");
+		return std::fclose(file) == 0;
+	}
+
+	// writes the latency results as a JSON array of objects that hold the
+	// name, the number of samples and the p50, p99, p99.9 and maximum 
+	// latency in nanoseconds
+	inline bool write_json(const std::vector<latency_result>& results, const std::string& path) {
+		std::FILE* file = std::fopen(path.c_str(), "w");
+		if (!file)
+			return false;
+		std::fprintf(file, "[\n");
+		for (size_t i = 0; i < results.size(); ++i) {
+			const latency_result& r = results[i];
+			std::fprintf(file, "  { \"name\": \"%s\", \"samples\": %llu, \"p50_ns\": %llu, \"p99_ns\": %llu, "
+				"\"p999_ns\": %llu, \"max_ns\": %llu }%s\n", json_escape(r.name).c_str(),
+				static_cast<unsigned long long>(r.latencies.count()),
+				static_cast<unsigned long long>(r.latencies.percentile(0.5)),
+				static_cast<unsigned long long>(r.latencies.percentile(0.99)),
+				static_cast<unsigned long long>(r.latencies.percentile(0.999)),
+				static_cast<unsigned long long>(r.latencies.max()),
+				i + 1 < results.size() ? "," : "");
+		}
+		std::fprintf(file, "]\n");
+		return std::fclose(file) == 0;
+	}
+
+	// prints the results, and also writes them as JSON to the path that
+	// follows a --json argument
+	template <class Result>
+	int report(const std::vector<Result>& results, int argc, char** argv) {
+		print(results);
+		for (int i = 1; i + 1 < argc; ++i) {
+			if (std::string(argv[i]) == "--json" && !write_json(results, argv[i + 1])) {
+				std::fprintf(stderr, "failed to write %s\n", argv[i + 1]);
+				return EXIT_FAILURE;
+			}
+		}
+		return EXIT_SUCCESS;
+	}
+
+}
@@ -0,0 +1,98 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Measures the build time and object size of translation units that use
+// proto, with the compiler the benchmarks are built with.
+
+namespace {
+
+	constexpr int num_signatures = 100;
+	constexpr int num_batches = 3;
+
+	struct result {
+		std::string name;
+		double ms;
+		uintmax_t object_bytes;
+	};
+
+	std::string signature(int i) {
+		return "void(tag<" + std::to_string(i) + ">, int&)";
+	}
+
+	// a translation unit that connects, emits and disconnects a signal of
+	// each signature, prologue goes between the declarations and the uses
+	std::string signal_source(const std::string& prologue) {
+		std::string source =
+			"#include <proto/proto.hpp>\n"
+			"template <int N> struct tag {};\n" + prologue;
+		for (int i = 0; i < num_signatures; ++i) {
+			const std::string tag = "tag<" + std::to_string(i) + ">";
+			source += "int use" + std::to_string(i) + "() {\n"
+				"\tproto::signal<" + signature(i) + "> signal;\n"
+				"\tint sum = 0;\n"
+				"\tproto::connection conn = signal.connect([](" + tag + ", int& x) { ++x; });\n"
+				"\tsignal.connect([&sum](" + tag + ", int& x) { sum += x; });\n"
+				"\tsignal(" + tag + "(), sum);\n"
+				"\tconn.close();\n"
+				"\treturn sum;\n"
+				"}\n";
+		}
+		return source;
+	}
+
+	std::string signal_declarations(const char* macro) {
+		std::string declarations;
+		for (int i = 0; i < num_signatures; ++i)
+			declarations += std::string(macro) + "(" + signature(i) + ");\n";
+		return declarations;
+	}
+
+	result compile(const std::string& name, const std::string& source) {
+		namespace fs = std::filesystem;
+		const fs::path dir = fs::temp_directory_path() / "proto_compile_benchmarks";
+		fs::create_directories(dir);
+		const fs::path source_path = dir / (name + ".cpp");
+		const fs::path object_path = dir / (name + ".o");
+		std::ofstream(source_path) << source;
+
+#if defined(_MSC_VER)
+		const std::string command = std::string("\"") + PROTO_CXX_COMPILER + "\" /nologo /std:c++17 /O2 /EHsc /c /I\""
+			+ PROTO_INCLUDE_DIR + "\" \"" + source_path.string() + "\" /Fo\"" + object_path.string() + "\"";
+#else
+		const std::string command = std::string("\"") + PROTO_CXX_COMPILER + "\" -std=c++17 -O2 -c -I\""
+			+ PROTO_INCLUDE_DIR + "\" \"" + source_path.string() + "\" -o \"" + object_path.string() + "\"";
+#endif
+
+		double best = 0;
+		for (int i = 0; i < num_batches; ++i) {
+			auto start = std::chrono::steady_clock::now();
+			if (std::system(command.c_str()) != 0) {
+				std::fprintf(stderr, "failed to compile %s\n", source_path.string().c_str());
+				std::exit(EXIT_FAILURE);
+			}
+			double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			best = i == 0 || ms < best ? ms : best;
+		}
+		return { name, best, fs::file_size(object_path) };
+	}
+
+}
+
+int main() {
+	const std::string n = std::to_string(num_signatures);
+	std::vector<result> results;
+	results.push_back(compile("include_only", "#include <proto/proto.hpp>\n"));
+	results.push_back(compile("signatures_" + n, signal_source("")));
+	results.push_back(compile("signatures_" + n + "_extern", signal_source(signal_declarations("PROTO_EXTERN_SIGNAL"))));
+	results.push_back(compile("signatures_" + n + "_instantiations", signal_source(signal_declarations("PROTO_INSTANTIATE_SIGNAL"))));
+
+	std::printf("%-40s %12s %14s\n", "name", "ms", "object bytes");
+	for (const result& r : results)
+		std::printf("%-40s %12.1f %14llu\n", r.name.c_str(), r.ms, static_cast<unsigned long long>(r.object_bytes));
+}
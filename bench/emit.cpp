@@ -0,0 +1,199 @@
+#include "bench.hpp"
+#include <proto/proto.hpp>
+#include <proto/routed_signal.hpp>
+#include <proto/topic_hub.hpp>
+#include <map>
+#include <functional>
+
+namespace {
+
+	int counter = 0;
+
+	void count(int x) noexcept {
+		counter += x;
+	}
+
+	// Slot is the type the free function is connected as, std::function
+	// forces type erasure where a plain function pointer would be stored
+	template <class Signal, class Slot = void(*)(int) noexcept>
+	bench::result emit(const std::string& name, size_t num_slots) {
+		Signal signal;
+		for (size_t i = 0; i < num_slots; ++i)
+			signal.connect(Slot(count));
+
+		return bench::measure(name + "/" + std::to_string(num_slots), [&] {
+			signal.emit(1);
+			bench::do_not_optimize(counter);
+		});
+	}
+
+	// the slot layout proto used before the hot/cold split, kept as a
+	// reference for the cache behavior of emission
+	bench::result emit_map_layout(const std::string& name, size_t num_slots) {
+		std::map<uint64_t, std::function<void(int)>> slots;
+		for (size_t i = 0; i < num_slots; ++i)
+			slots.emplace(i, count);
+
+		return bench::measure(name + "/" + std::to_string(num_slots), [&] {
+			for (auto&[_, slot] : slots)
+				slot(1);
+			bench::do_not_optimize(counter);
+		});
+	}
+
+	struct add_slot {
+		int offset;
+		void operator()(int x) const { counter += x + offset; }
+	};
+
+	// wires num_slots slots into a new signal the way a service does at
+	// startup, one connect at a time or as a range
+	template <class Signal, bool Reserve, bool Range>
+	bench::result wire(const std::string& name, size_t num_slots) {
+		std::vector<add_slot> slots(num_slots, add_slot{ 1 });
+
+		return bench::measure(name + "/" + std::to_string(num_slots), [&] {
+			Signal signal;
+			std::vector<proto::connection> conns;
+			if constexpr (Range) {
+				conns = signal.connect_range(slots.begin(), slots.end());
+			}
+			else {
+				if constexpr (Reserve) {
+					signal.reserve(num_slots);
+					conns.reserve(num_slots);
+				}
+				for (const add_slot& slot : slots)
+					conns.push_back(signal.connect(slot));
+			}
+			bench::do_not_optimize(conns.data());
+		});
+	}
+
+	// num_slots slots of which one in every thousand is interested in the
+	// emitted event, emitted with a mask or with a check in every slot
+	template <class Signal, bool Masked>
+	bench::result emit_sparse(const std::string& name, size_t num_slots) {
+		constexpr uint64_t event = 1;
+		Signal signal;
+		for (size_t i = 0; i < num_slots; ++i) {
+			const uint64_t mask = i % 1000 == 0 ? event : 2;
+			if constexpr (Masked)
+				signal.connect([](uint64_t, int x) { count(x); }, mask);
+			else
+				signal.connect([mask](uint64_t e, int x) { if (mask & e) count(x); });
+		}
+
+		return bench::measure(name + "/" + std::to_string(num_slots), [&] {
+			if constexpr (Masked)
+				signal.emit_masked(event, event, 1);
+			else
+				signal.emit(event, 1);
+			bench::do_not_optimize(counter);
+		});
+	}
+
+	// a topic hub with num_filters filters, of which four match the 
+	// emitted topic, emitted with and without its route cached
+	bench::result emit_topic(const std::string& name, size_t num_filters, bool cached) {
+		proto::topic_hub<void(int)> hub(cached ? 1024 : 1);
+		for (size_t i = 0; i < num_filters; ++i)
+			hub.connect("orders." + std::to_string(i) + ".filled", count);
+		for (const char* filter : { "orders.7.filled", "orders.*.filled", "orders.#", "*.7.*" })
+			hub.connect(filter, count);
+
+		return bench::measure(name + "/" + std::to_string(num_filters), [&] {
+			hub.emit("orders.7.filled", 1);
+			if (!cached)
+				hub.emit("orders.8.filled", 1);
+			bench::do_not_optimize(counter);
+		});
+	}
+
+	// num_slots slots that each take a band of 10 out of 100000 keys,
+	// emitted through a routed signal or to slots that check the band
+	template <bool Routed>
+	bench::result emit_routed(const std::string& name, size_t num_slots) {
+		proto::signal<void(int)> filtered;
+		proto::routed_signal<void(int), int> routed([](int key) { return key; });
+		for (size_t i = 0; i < num_slots; ++i) {
+			const int low = static_cast<int>(i * 100000 / num_slots);
+			if constexpr (Routed)
+				routed.connect(count, { low, low + 9 });
+			else
+				filtered.connect([low](int key) { if (low <= key && key <= low + 9) count(1); });
+		}
+
+		int key = 0;
+		return bench::measure(name + "/" + std::to_string(num_slots), [&] {
+			key = (key + 7919) % 100000;
+			if constexpr (Routed)
+				routed.emit(key);
+			else
+				filtered.emit(key);
+			bench::do_not_optimize(counter);
+		});
+	}
+
+	template <class F>
+	bench::result invoke_delegate(const std::string& name, F target) {
+		proto::delegate<void(int)> delegate;
+		delegate.connect(target);
+
+		return bench::measure(name, [&] {
+			delegate(1);
+			bench::do_not_optimize(counter);
+		});
+	}
+
+	bench::result invoke_function_pointer(const std::string& name) {
+		void(*volatile function)(int) = count;
+
+		return bench::measure(name, [&] {
+			function(1);
+			bench::do_not_optimize(counter);
+		});
+	}
+
+}
+
+int main(int argc, char** argv) {
+	std::vector<bench::result> results;
+	for (size_t num_slots : { 1, 8, 64, 500, 5000 }) {
+		results.push_back(emit<proto::signal<void(int)>>("emit/propagate_exceptions", num_slots));
+		results.push_back(emit<proto::signal<void(int), proto::isolate_exceptions>>("emit/isolate_exceptions", num_slots));
+		results.push_back(emit<proto::signal<void(int), proto::terminate_on_exception>>("emit/terminate_on_exception", num_slots));
+		results.push_back(emit<proto::signal<void(int) noexcept>>("emit/noexcept_signature", num_slots));
+		results.push_back(emit<proto::small_signal<void(int), 8>>("emit/small_signal_8", num_slots));
+		if (num_slots <= 64)
+			results.push_back(emit<proto::fixed_signal<void(int), 64>>("emit/fixed_signal_64", num_slots));
+		results.push_back(emit<proto::paged_signal<void(int)>>("emit/paged_signal", num_slots));
+		results.push_back(emit<proto::signal<void(int)>, std::function<void(int)>>("emit/type_erased_function", num_slots));
+		results.push_back(emit_map_layout("emit/map_layout", num_slots));
+	}
+	for (size_t num_slots : { 64, 40000 }) {
+		results.push_back(wire<proto::signal<void(int)>, false, false>("wire/connect", num_slots));
+		results.push_back(wire<proto::signal<void(int)>, true, false>("wire/reserve_connect", num_slots));
+		results.push_back(wire<proto::signal<void(int)>, false, true>("wire/connect_range", num_slots));
+		results.push_back(wire<proto::paged_signal<void(int)>, false, false>("wire/paged_signal_connect", num_slots));
+	}
+	for (size_t num_slots : { 500, 5000 }) {
+		results.push_back(emit_sparse<proto::signal<void(uint64_t, int)>, false>("sparse/filter_in_slot", num_slots));
+		results.push_back(emit_sparse<proto::signal<void(uint64_t, int)>, true>("sparse/emit_masked", num_slots));
+		results.push_back(emit_sparse<proto::paged_signal<void(uint64_t, int)>, true>("sparse/paged_signal_emit_masked", num_slots));
+		results.push_back(emit_sparse<proto::basic_signal<void(uint64_t, int), proto::rcu_snapshots>, true>("sparse/rcu_snapshots_emit_masked", num_slots));
+	}
+	for (size_t num_filters : { 10, 1000 }) {
+		results.push_back(emit_topic("topic_hub/cached", num_filters, true));
+		results.push_back(emit_topic("topic_hub/uncached_pair", num_filters, false));
+	}
+	for (size_t num_slots : { 500, 5000 }) {
+		results.push_back(emit_routed<false>("routed/filter_in_slot", num_slots));
+		results.push_back(emit_routed<true>("routed/routed_signal", num_slots));
+	}
+	results.push_back(invoke_function_pointer("invoke/function_pointer"));
+	results.push_back(invoke_delegate("invoke/delegate_function", count));
+	results.push_back(invoke_delegate("invoke/delegate_lambda", [](int x) { counter += x; }));
+	results.push_back(invoke_delegate("invoke/delegate_capturing_lambda", [&x = counter](int y) { x += y; }));
+	return bench::report(results, argc, argv);
+}
@@ -0,0 +1,145 @@
+#include "bench.hpp"
+#include <proto/proto.hpp>
+#include <memory>
+#include <mutex>
+
+// Measures the latency of single operations while other threads churn the
+// signal, which exposes the stalls that throughput benchmarks average away:
+// reallocation spikes, lock convoys and reclamation pauses.
+
+namespace {
+
+	using clock = std::chrono::steady_clock;
+
+	constexpr auto run_time = std::chrono::milliseconds(500);
+	constexpr size_t num_slots = 64;
+	constexpr size_t num_receivers = 16;
+	constexpr size_t num_growth_slots = size_t(1) << 20;
+
+	std::atomic<uint64_t> counter{ 0 };
+
+	void count(int x) noexcept {
+		counter.fetch_add(x, std::memory_order_relaxed);
+	}
+
+	uint64_t elapsed_ns(clock::time_point start) {
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+	}
+
+	struct counting_receiver : proto::receiver {
+		void on_emit(int x) { count(x); }
+	};
+
+	// One thread emits for run_time while the others connect and close
+	// slots, replace receivers, and move a signal of their own. A slot that
+	// is running when its receiver is destroyed is not waited for, so the
+	// replaced receivers are handed off to the emitting thread, which 
+	// destroys them between its timed emissions, when none of their slots
+	// can be running.
+	template <class ThreadingPolicy>
+	void emit_under_churn(std::vector<bench::latency_result>& results, const std::string& name) {
+		using signal_type = proto::basic_signal<void(int), ThreadingPolicy>;
+
+		signal_type signal;
+		for (size_t i = 0; i < num_slots; ++i)
+			signal.connect(count);
+
+		bench::latency_result emits{ name + "/emit", {} };
+		bench::latency_result churns{ name + "/connect_close", {} };
+		std::mutex retired_mutex;
+		std::vector<std::unique_ptr<counting_receiver>> retired;
+		std::atomic<bool> done{ false };
+		std::vector<std::thread> threads;
+
+		threads.emplace_back([&] {
+			while (!done.load(std::memory_order_relaxed)) {
+				auto start = clock::now();
+				signal.connect([](int x) { count(x); }).close();
+				churns.latencies.record(elapsed_ns(start));
+			}
+		});
+
+		// the receivers that remain connected at the end are destroyed once
+		// the emitting thread has stopped
+		threads.emplace_back([&] {
+			std::unique_ptr<counting_receiver> receivers[num_receivers];
+			for (size_t i = 0; !done.load(std::memory_order_relaxed); i = (i + 1) % num_receivers) {
+				bool full;
+				{
+					std::lock_guard<std::mutex> lock(retired_mutex);
+					full = retired.size() >= num_receivers;
+					if (!full && receivers[i])
+						retired.push_back(std::move(receivers[i]));
+				}
+				if (full) {
+					std::this_thread::yield();
+					continue;
+				}
+				receivers[i] = std::make_unique<counting_receiver>();
+				signal.connect(receivers[i].get(), &counting_receiver::on_emit);
+			}
+		});
+
+		threads.emplace_back([&] {
+			signal_type local;
+			std::vector<proto::connection> conns;
+			for (size_t i = 0; i < num_slots; ++i)
+				conns.push_back(local.connect(count));
+			while (!done.load(std::memory_order_relaxed)) {
+				signal_type moved(std::move(local));
+				local = std::move(moved);
+			}
+		});
+
+		std::vector<std::unique_ptr<counting_receiver>> destroyed;
+		const auto end = clock::now() + run_time;
+		while (clock::now() < end) {
+			auto start = clock::now();
+			signal.emit(1);
+			emits.latencies.record(elapsed_ns(start));
+			{
+				std::lock_guard<std::mutex> lock(retired_mutex);
+				destroyed.swap(retired);
+			}
+			destroyed.clear();
+		}
+
+		done = true;
+		for (std::thread& thread : threads)
+			thread.join();
+		retired.clear();
+		signal.clear();
+		results.push_back(std::move(emits));
+		results.push_back(std::move(churns));
+	}
+
+	// Connects num_growth_slots slots one at a time, where a contiguous
+	// signal stalls whenever its slot arrays grow.
+	template <class Signal>
+	void connect_growth(std::vector<bench::latency_result>& results, const std::string& name, bool reserve) {
+		Signal signal;
+		if (reserve)
+			signal.reserve(num_growth_slots);
+
+		bench::latency_result connects{ name + "/connect", {} };
+		for (size_t i = 0; i < num_growth_slots; ++i) {
+			auto start = clock::now();
+			signal.connect([i](int x) { count(x + int(i & 1)); });
+			connects.latencies.record(elapsed_ns(start));
+		}
+		results.push_back(std::move(connects));
+	}
+
+}
+
+int main(int argc, char** argv) {
+	std::vector<bench::latency_result> results;
+	emit_under_churn<proto::spin_locked>(results, "spin_locked");
+	emit_under_churn<proto::shared_locked>(results, "shared_locked");
+	emit_under_churn<proto::rcu_snapshots>(results, "rcu_snapshots");
+	emit_under_churn<proto::numa_replicated<proto::rcu_snapshots>>(results, "numa_replicated<rcu_snapshots>");
+	connect_growth<proto::signal<void(int)>>(results, "growth/signal", false);
+	connect_growth<proto::signal<void(int)>>(results, "growth/signal_reserved", true);
+	connect_growth<proto::paged_signal<void(int)>>(results, "growth/paged_signal", false);
+	return bench::report(results, argc, argv);
+}
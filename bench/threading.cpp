@@ -0,0 +1,60 @@
+#include "bench.hpp"
+#include <proto/proto.hpp>
+
+namespace {
+
+	constexpr size_t num_slots = 8;
+	constexpr uint64_t num_emissions = 20000;
+
+	std::atomic<uint64_t> counter{ 0 };
+
+	void count(int x) noexcept {
+		counter.fetch_add(x, std::memory_order_relaxed);
+	}
+
+	// every thread emits, the churn thread connects and disconnects a slot
+	// in a loop until they are done
+	template <class ThreadingPolicy>
+	bench::result emit(const std::string& name, size_t num_threads, bool churn) {
+		proto::basic_signal<void(int), ThreadingPolicy> signal;
+		for (size_t i = 0; i < num_slots; ++i)
+			signal.connect(count);
+
+		std::atomic<bool> done{ false };
+		std::thread churner;
+		if (churn) {
+			churner = std::thread([&] {
+				while (!done.load(std::memory_order_relaxed))
+					signal.connect(count).close();
+			});
+		}
+
+		auto result = bench::measure_threads(
+			name + (churn ? "/churn/" : "/emit/") + std::to_string(num_threads), num_threads, num_emissions,
+			[&](size_t) { signal.emit(1); });
+
+		done = true;
+		if (churner.joinable())
+			churner.join();
+		return result;
+	}
+
+	template <class ThreadingPolicy>
+	void emit_matrix(std::vector<bench::result>& results, const std::string& name) {
+		for (bool churn : { false, true })
+			for (size_t num_threads : { 1, 2, 4, 8, 16, 32, 64 })
+				results.push_back(emit<ThreadingPolicy>(name, num_threads, churn));
+	}
+
+}
+
+int main(int argc, char** argv) {
+	std::vector<bench::result> results;
+	// the baseline, single threaded signals cannot be shared
+	results.push_back(emit<proto::single_threaded>("single_threaded", 1, false));
+	emit_matrix<proto::spin_locked>(results, "spin_locked");
+	emit_matrix<proto::shared_locked>(results, "shared_locked");
+	emit_matrix<proto::rcu_snapshots>(results, "rcu_snapshots");
+	emit_matrix<proto::numa_replicated<proto::rcu_snapshots>>(results, "numa_replicated<rcu_snapshots>");
+	return bench::report(results, argc, argv);
+}
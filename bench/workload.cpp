@@ -0,0 +1,309 @@
+#include "bench.hpp"
+#include <proto/proto.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <random>
+
+// Replays a seeded mix of operations on a graph of signals shaped like an
+// application: thousands of signals with heavy tailed subscriber counts,
+// receivers subscribed to many signals, and slots that emit other signals.
+// Reports throughput, resident memory and allocation counts.
+//
+// Options are given as --name=value, see config for the names and their
+// defaults.
+
+namespace {
+
+	uint64_t num_allocations = 0;
+	uint64_t num_allocated_bytes = 0;
+
+}
+
+void* operator new(std::size_t size) {
+	if (void* ptr = std::malloc(size ? size : 1)) {
+		++num_allocations;
+		num_allocated_bytes += size;
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
+
+namespace {
+
+	struct config {
+		size_t signals = 2000;
+		size_t receivers = 5000;
+		// connections made while the graph is built
+		size_t connections = 50000;
+		size_t operations = 200000;
+		uint64_t seed = 1;
+		// exponent of the Zipf distribution that picks the signal of a
+		// connection or an emission, higher is more skewed
+		double zipf = 1.1;
+		// the share of each operation in the mix, the rest are emissions
+		double connect = 0.04;
+		double disconnect = 0.04;
+		double churn = 0.01;
+		// the share of lambda slots that emit another signal
+		double nested = 0.005;
+		// the depth at which nested slots stop emitting
+		size_t depth = 3;
+		// the share of connections made by receivers
+		double receiver_share = 0.6;
+	};
+
+	config parse(int argc, char** argv) {
+		config c;
+		for (int i = 1; i < argc; ++i) {
+			const std::string arg = argv[i];
+			const size_t equals = arg.find('=');
+			if (arg.compare(0, 2, "--") != 0 || equals == std::string::npos) {
+				std::fprintf(stderr, "ignoring %s, options are given as --name=value\n", argv[i]);
+				continue;
+			}
+			const std::string name = arg.substr(2, equals - 2);
+			const char* value = arg.c_str() + equals + 1;
+			if (name == "signals") c.signals = std::strtoull(value, nullptr, 10);
+			else if (name == "receivers") c.receivers = std::strtoull(value, nullptr, 10);
+			else if (name == "connections") c.connections = std::strtoull(value, nullptr, 10);
+			else if (name == "operations") c.operations = std::strtoull(value, nullptr, 10);
+			else if (name == "seed") c.seed = std::strtoull(value, nullptr, 10);
+			else if (name == "zipf") c.zipf = std::strtod(value, nullptr);
+			else if (name == "connect") c.connect = std::strtod(value, nullptr);
+			else if (name == "disconnect") c.disconnect = std::strtod(value, nullptr);
+			else if (name == "churn") c.churn = std::strtod(value, nullptr);
+			else if (name == "nested") c.nested = std::strtod(value, nullptr);
+			else if (name == "depth") c.depth = std::strtoull(value, nullptr, 10);
+			else if (name == "receiver_share") c.receiver_share = std::strtod(value, nullptr);
+			else std::fprintf(stderr, "ignoring unknown option %s\n", name.c_str());
+		}
+		if (c.signals == 0)
+			c.signals = 1;
+		if (c.receivers == 0)
+			c.receivers = 1;
+		return c;
+	}
+
+	// samples ranks in [0, n) with a probability proportional to
+	// 1 / (rank + 1)^exponent
+	class zipf_distribution {
+	public:
+		zipf_distribution(size_t n, double exponent)
+			: m_cdf(n)
+		{
+			double sum = 0;
+			for (size_t i = 0; i < n; ++i)
+				m_cdf[i] = sum += 1.0 / std::pow(double(i + 1), exponent);
+			for (double& p : m_cdf)
+				p /= sum;
+		}
+
+		template <class Engine>
+		size_t operator()(Engine& engine) const {
+			const double u = std::uniform_real_distribution<double>(0, 1)(engine);
+			size_t first = 0;
+			size_t count = m_cdf.size();
+			while (count > 0) {
+				const size_t step = count / 2;
+				if (m_cdf[first + step] < u) {
+					first += step + 1;
+					count -= step + 1;
+				}
+				else {
+					count = step;
+				}
+			}
+			return first < m_cdf.size() ? first : m_cdf.size() - 1;
+		}
+
+	private:
+		std::vector<double> m_cdf;
+	};
+
+	uint64_t num_invocations = 0;
+
+	struct subscriber : proto::receiver {
+		void on_signal(int x) {
+			sum += uint64_t(x);
+			++num_invocations;
+		}
+
+		uint64_t sum = 0;
+	};
+
+	class workload {
+	public:
+		explicit workload(const config& c)
+			: m_config(c)
+			, m_engine(c.seed)
+			, m_pick_signal(c.signals, c.zipf)
+			, m_signals(c.signals)
+			, m_subscribers(c.receivers)
+		{
+			for (auto& s : m_subscribers)
+				s = std::make_unique<subscriber>();
+			for (size_t i = 0; i < c.connections; ++i)
+				connect();
+		}
+
+		void run(size_t num_operations) {
+			std::uniform_real_distribution<double> pick_operation(0, 1);
+			for (size_t i = 0; i < num_operations; ++i) {
+				double p = pick_operation(m_engine);
+				if ((p -= m_config.connect) < 0)
+					connect();
+				else if ((p -= m_config.disconnect) < 0)
+					disconnect();
+				else if ((p -= m_config.churn) < 0)
+					churn();
+				else
+					emit();
+			}
+		}
+
+		uint64_t num_emissions() const noexcept { return m_num_emissions; }
+		size_t num_scoped_connections() const noexcept { return m_connections.size(); }
+
+		size_t num_slots() const noexcept {
+			size_t count = 0;
+			for (const auto& signal : m_signals)
+				count += signal.size();
+			return count;
+		}
+
+	private:
+		size_t uniform(size_t n) {
+			return std::uniform_int_distribution<size_t>(0, n - 1)(m_engine);
+		}
+
+		bool chance(double p) {
+			return std::uniform_real_distribution<double>(0, 1)(m_engine) < p;
+		}
+
+		// connects a receiver or a lambda slot to a signal picked by the
+		// Zipf distribution, some lambda slots emit another signal
+		void connect() {
+			proto::signal<void(int)>& signal = m_signals[m_pick_signal(m_engine)];
+			if (chance(m_config.receiver_share)) {
+				subscriber& s = *m_subscribers[uniform(m_subscribers.size())];
+				signal.connect(&s, &subscriber::on_signal);
+			}
+			else if (chance(m_config.nested)) {
+				const size_t target = uniform(m_signals.size());
+				m_connections.emplace_back(signal.connect([this, target](int x) {
+					++num_invocations;
+					if (m_depth < m_config.depth) {
+						++m_depth;
+						m_signals[target].emit(x + 1);
+						--m_depth;
+					}
+				}));
+			}
+			else {
+				m_connections.emplace_back(signal.connect([](int) { ++num_invocations; }));
+			}
+		}
+
+		void disconnect() {
+			if (m_connections.empty())
+				return;
+			const size_t i = uniform(m_connections.size());
+			std::swap(m_connections[i], m_connections.back());
+			m_connections.pop_back();
+		}
+
+		// replaces a receiver, which disconnects all of its slots, with a
+		// new one subscribed to as many signals
+		void churn() {
+			std::unique_ptr<subscriber>& s = m_subscribers[uniform(m_subscribers.size())];
+			const size_t num_connections = s->num_connections();
+			s = std::make_unique<subscriber>();
+			for (size_t i = 0; i < num_connections; ++i)
+				m_signals[m_pick_signal(m_engine)].connect(s.get(), &subscriber::on_signal);
+		}
+
+		void emit() {
+			++m_num_emissions;
+			m_signals[m_pick_signal(m_engine)].emit(1);
+		}
+
+		const config& m_config;
+		std::mt19937_64 m_engine;
+		zipf_distribution m_pick_signal;
+		std::vector<proto::signal<void(int)>> m_signals;
+		std::vector<std::unique_ptr<subscriber>> m_subscribers;
+		std::vector<proto::scoped_connection> m_connections;
+		uint64_t m_num_emissions = 0;
+		size_t m_depth = 0;
+	};
+
+	// the current and peak resident set size in KiB, or zero where they
+	// cannot be read
+	std::pair<uint64_t, uint64_t> resident_kib() {
+		uint64_t current = 0;
+		uint64_t peak = 0;
+#if defined(__linux__)
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		while (std::getline(status, line)) {
+			if (line.compare(0, 6, "VmRSS:") == 0)
+				current = std::strtoull(line.c_str() + 6, nullptr, 10);
+			else if (line.compare(0, 6, "VmHWM:") == 0)
+				peak = std::strtoull(line.c_str() + 6, nullptr, 10);
+		}
+#endif
+		return { current, peak };
+	}
+
+}
+
+int main(int argc, char** argv) {
+	using clock = std::chrono::steady_clock;
+	const config c = parse(argc, argv);
+
+	auto start = clock::now();
+	const uint64_t build_allocations = num_allocations;
+	workload w(c);
+	const double build_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	const uint64_t graph_allocations = num_allocations - build_allocations;
+	const size_t num_slots = w.num_slots();
+
+	const uint64_t run_allocations = num_allocations;
+	const uint64_t run_bytes = num_allocated_bytes;
+	const uint64_t run_invocations = num_invocations;
+	start = clock::now();
+	w.run(c.operations);
+	const double run_s = std::chrono::duration<double>(clock::now() - start).count();
+	const auto [rss, peak_rss] = resident_kib();
+
+	std::printf("signals              %zu\n", c.signals);
+	std::printf("receivers            %zu\n", c.receivers);
+	std::printf("slots                %zu built, %zu after the run\n", num_slots, w.num_slots());
+	std::printf("build                %.1f ms, %llu allocations\n", build_ms,
+		static_cast<unsigned long long>(graph_allocations));
+	std::printf("operations           %zu in %.3f s, %.0f ops/s\n", c.operations, run_s, double(c.operations) / run_s);
+	std::printf("emissions            %llu, %.0f per second\n", static_cast<unsigned long long>(w.num_emissions()),
+		double(w.num_emissions()) / run_s);
+	std::printf("slot invocations     %llu, %.0f per second\n",
+		static_cast<unsigned long long>(num_invocations - run_invocations), double(num_invocations - run_invocations) / run_s);
+	std::printf("run allocations      %llu, %.3f per operation, %llu bytes\n",
+		static_cast<unsigned long long>(num_allocations - run_allocations),
+		double(num_allocations - run_allocations) / double(c.operations ? c.operations : 1),
+		static_cast<unsigned long long>(num_allocated_bytes - run_bytes));
+	if (rss)
+		std::printf("resident memory      %llu KiB, peak %llu KiB\n",
+			static_cast<unsigned long long>(rss), static_cast<unsigned long long>(peak_rss));
+	else
+		std::printf("resident memory      -\n");
+}
@@ -0,0 +1,53 @@
+// C++20 module interface of proto, built by the proto_module target. 
+// Importers see the same names as includers of proto.hpp and the headers
+// next to it, except for the PROTO_ instantiation macros, which modules 
+// cannot export.
+
+module;
+
+#include "proto.hpp"
+#include "routed_signal.hpp"
+#include "topic_hub.hpp"
+
+export module proto;
+
+export namespace proto {
+
+	using proto::emission_error;
+	using proto::propagate_exceptions;
+	using proto::isolate_exceptions;
+	using proto::terminate_on_exception;
+
+	using proto::single_threaded;
+	using proto::inline_single_threaded;
+	using proto::fixed_single_threaded;
+	using proto::paged_single_threaded;
+	using proto::spin_locked;
+	using proto::shared_locked;
+	using proto::rcu_snapshots;
+	using proto::numa_replicated;
+
+	using proto::basic_signal;
+	using proto::signal;
+	using proto::small_signal;
+	using proto::fixed_signal;
+	using proto::paged_signal;
+	using proto::delegate;
+	using proto::topic_hub;
+	using proto::routed_signal;
+	using proto::key_range;
+
+	using proto::all_events;
+	using proto::connection;
+	using proto::scoped_connection;
+	using proto::receiver;
+	using proto::small_vector;
+
+	namespace numa {
+		using proto::numa::topology;
+		using proto::numa::override_topology;
+		using proto::numa::num_nodes;
+		using proto::numa::current_node;
+	}
+
+}
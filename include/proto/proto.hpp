@@ -35,19 +35,556 @@ SOFTWARE.
 
 #pragma once
 
-#include <map>
 #include <vector>
+#include <tuple>
+#include <new>
 #include <memory>
+#include <cstddef>
 #include <cstdint>
+#include <exception>
 #include <cassert>
-#include <algorithm>
+#include <optional>
+#include <iterator>
+#include <utility>
 #include <functional>
+#include <cstdio>
+#include <shared_mutex>
+#include <mutex>
+#include <thread>
+#include <atomic>
 #include <type_traits>
 
+#if defined(__linux__)
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+// glibc answers getcpu from the vDSO without entering the kernel
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+#define PROTO_HAS_GETCPU
+#endif
+#endif
+
+// interest masks are scanned in blocks with the widest vector instructions
+// the target is compiled for, PROTO_NO_SIMD keeps the scalar scan
+#if !defined(PROTO_NO_SIMD)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PROTO_HAS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PROTO_HAS_SSE2
+#endif
+#endif
+
 namespace proto {
 
-	template <class Callable>
-	class signal;
+	// Raised by emissions under isolate_exceptions once every slot has been
+	// invoked, holds the exceptions thrown by the slots in invocation order.
+	class emission_error final : public std::exception {
+	public:
+		explicit emission_error(std::vector<std::exception_ptr> exceptions) noexcept
+			: m_exceptions(std::move(exceptions)) {}
+
+		const char* what() const noexcept override {
+			return "proto::emission_error: slots threw during emission";
+		}
+
+		const std::vector<std::exception_ptr>& exceptions() const noexcept {
+			return m_exceptions;
+		}
+
+	private:
+		std::vector<std::exception_ptr> m_exceptions;
+	};
+
+	// Exception policies decide what happens when a slot throws. Each policy
+	// provides a handler that lives for the duration of one emission: 
+	// handler::invoke runs a slot and returns whether it completed, and 
+	// handler::finish runs once the emission has visited every slot.
+
+	// An exception thrown by a slot leaves the emission immediately, the 
+	// remaining slots are not invoked.
+	struct propagate_exceptions {
+		static constexpr bool nothrow = false;
+
+		class handler {
+		public:
+			template <class Invoke>
+			constexpr bool invoke(Invoke&& invoke) {
+				invoke();
+				return true;
+			}
+
+			constexpr void finish() noexcept {}
+		};
+	};
+
+	// Exceptions thrown by slots are caught so the remaining slots still run,
+	// afterwards they are raised together as a proto::emission_error.
+	struct isolate_exceptions {
+		static constexpr bool nothrow = false;
+
+		class handler {
+		public:
+			template <class Invoke>
+			bool invoke(Invoke&& invoke) noexcept {
+				try {
+					invoke();
+					return true;
+				}
+				catch (...) {
+					m_exceptions.push_back(std::current_exception());
+					return false;
+				}
+			}
+
+			void finish() {
+				if (!m_exceptions.empty())
+					throw emission_error(std::move(m_exceptions));
+			}
+
+		private:
+			std::vector<std::exception_ptr> m_exceptions;
+		};
+	};
+
+	// Emission is noexcept, an exception thrown by a slot calls std::terminate.
+	struct terminate_on_exception {
+		static constexpr bool nothrow = true;
+
+		using handler = propagate_exceptions::handler;
+	};
+
+	namespace detail {
+
+		struct null_mutex {
+			void lock() noexcept {}
+			bool try_lock() noexcept { return true; }
+			void unlock() noexcept {}
+		};
+
+		// A test and test-and-set lock for critical sections that last a 
+		// handful of instructions.
+		class spin_mutex {
+		public:
+			void lock() noexcept {
+				while (m_locked.exchange(true, std::memory_order_acquire))
+					while (m_locked.load(std::memory_order_relaxed))
+						std::this_thread::yield();
+			}
+
+			bool try_lock() noexcept {
+				return !m_locked.load(std::memory_order_relaxed)
+					&& !m_locked.exchange(true, std::memory_order_acquire);
+			}
+
+			void unlock() noexcept {
+				m_locked.store(false, std::memory_order_release);
+			}
+
+		private:
+			std::atomic<bool> m_locked{ false };
+		};
+
+		template <class Mutex, class = std::void_t<>>
+		struct is_shared_mutex : std::false_type {};
+
+		template <class Mutex>
+		struct is_shared_mutex<Mutex, std::void_t<decltype(std::declval<Mutex&>().lock_shared())>>
+			: std::true_type {};
+
+		// Snapshot cells publish immutable versions of a value to concurrent
+		// readers. Writers must be serialized by the owner of the cell.
+
+		// Readers copy the current version out under Mutex, writers update a
+		// copy of it and swap it in.
+		template <class T, class Mutex>
+		class locked_cell {
+			using read_lock = std::conditional_t<is_shared_mutex<Mutex>::value,
+				std::shared_lock<Mutex>, std::lock_guard<Mutex>>;
+			using write_lock = std::lock_guard<Mutex>;
+		public:
+			using snapshot = std::shared_ptr<const T>;
+
+			locked_cell()
+				: m_value(std::make_shared<T>()) {}
+
+			locked_cell(locked_cell&& other)
+				: m_value(std::make_shared<T>()) 
+			{
+				swap(other);
+			}
+
+			snapshot load() const {
+				read_lock lock(m_mutex);
+				return m_value;
+			}
+
+			template <class Update>
+			void update(Update&& update) {
+				std::shared_ptr<T> value = std::make_shared<T>(*load());
+				update(*value);
+				// the replaced version is released after the lock
+				std::shared_ptr<const T> published(std::move(value));
+				write_lock lock(m_mutex);
+				m_value.swap(published);
+			}
+
+			void swap(locked_cell& other) {
+				using std::swap;
+				swap(m_value, other.m_value);
+			}
+
+		private:
+			mutable Mutex m_mutex;
+			std::shared_ptr<const T> m_value;
+		};
+
+		// Readers never block: they announce themselves in the reader count 
+		// of the current epoch before loading the current version. Replaced 
+		// versions are retired, and freed once the epoch has advanced twice,
+		// as by then every reader that could have loaded them has left.
+		template <class T>
+		class rcu_cell {
+			struct alignas(64) reader_count {
+				std::atomic<uint64_t> count{ 0 };
+			};
+		public:
+
+			class snapshot {
+			public:
+				snapshot(snapshot&& other) noexcept
+					: m_value(other.m_value)
+					, m_readers(std::exchange(other.m_readers, nullptr)) {}
+
+				snapshot(const snapshot&) = delete;
+				snapshot& operator=(const snapshot&) = delete;
+				snapshot& operator=(snapshot&&) = delete;
+
+				~snapshot() {
+					if (m_readers)
+						m_readers->fetch_sub(1, std::memory_order_release);
+				}
+
+				const T& operator*() const noexcept { return *m_value; }
+				const T* operator->() const noexcept { return m_value; }
+
+			private:
+				friend class rcu_cell;
+
+				snapshot(const T* value, std::atomic<uint64_t>* readers) noexcept
+					: m_value(value)
+					, m_readers(readers) {}
+
+				const T* m_value;
+				std::atomic<uint64_t>* m_readers;
+			};
+
+			rcu_cell()
+				: m_value(new T())
+				, m_epoch(0)
+				, m_readers()
+				, m_retired() {}
+
+			rcu_cell(rcu_cell&& other)
+				: rcu_cell() 
+			{
+				swap(other);
+			}
+
+			~rcu_cell() {
+				delete m_value.load(std::memory_order_relaxed);
+				for (auto&[_, value] : m_retired)
+					delete value;
+			}
+
+			snapshot load() const {
+				for (;;) {
+					uint64_t epoch = m_epoch.load();
+					std::atomic<uint64_t>& readers = m_readers[epoch & 1].count;
+					readers.fetch_add(1);
+					if (m_epoch.load() == epoch)
+						return snapshot(m_value.load(), &readers);
+					readers.fetch_sub(1, std::memory_order_release);
+				}
+			}
+
+			template <class Update>
+			void update(Update&& update) {
+				std::unique_ptr<T> value = std::make_unique<T>(*m_value.load(std::memory_order_relaxed));
+				update(*value);
+				m_retired.reserve(m_retired.size() + 1);
+				const T* retired = m_value.exchange(value.release());
+				m_retired.emplace_back(m_epoch.load(), retired);
+				reclaim();
+			}
+
+			// the cells must not have readers
+			void swap(rcu_cell& other) noexcept {
+				const T* value = m_value.load(std::memory_order_relaxed);
+				m_value.store(other.m_value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				other.m_value.store(value, std::memory_order_relaxed);
+				m_retired.swap(other.m_retired);
+			}
+
+		private:
+			void reclaim() {
+				// the epoch advances once the readers of the previous one, 
+				// which share their count with the next one, have left
+				for (int i = 0; i < 2; ++i) {
+					uint64_t epoch = m_epoch.load();
+					if (m_readers[(epoch + 1) & 1].count.load() != 0)
+						break;
+					m_epoch.store(epoch + 1);
+				}
+
+				// deletes the values no reader can see anymore and keeps the
+				// others in order
+				const uint64_t epoch = m_epoch.load();
+				size_t kept = 0;
+				for (auto& retired : m_retired) {
+					if (retired.first + 2 > epoch)
+						m_retired[kept++] = retired;
+					else
+						delete retired.second;
+				}
+				m_retired.resize(kept);
+			}
+
+			std::atomic<const T*> m_value;
+			std::atomic<uint64_t> m_epoch;
+			mutable reader_count m_readers[2];
+			std::vector<std::pair<uint64_t, const T*>> m_retired;
+		};
+
+	}
+
+	namespace numa {
+
+		// Describes the NUMA nodes of a machine, used to override the
+		// detected topology on machines that lack the nodes under test.
+		struct topology {
+			size_t num_nodes;
+			size_t(*current_node)() noexcept;
+		};
+
+		namespace detail {
+
+			inline std::atomic<const topology*> topology_override{ nullptr };
+
+			inline size_t detect_num_nodes() noexcept {
+				size_t num_nodes = 1;
+#if defined(__linux__)
+				// lists the possible nodes as a range, like "0-1"
+				if (std::FILE* file = std::fopen("/sys/devices/system/node/possible", "r")) {
+					unsigned first = 0;
+					unsigned last = 0;
+					int num_read = std::fscanf(file, "%u-%u", &first, &last);
+					if (num_read == 2)
+						num_nodes = size_t(last) + 1;
+					else if (num_read == 1)
+						num_nodes = size_t(first) + 1;
+					std::fclose(file);
+				}
+#endif
+				return num_nodes;
+			}
+
+		}
+
+		// replaces the detected topology until it is called with nullptr, the
+		// topology must outlive its use
+		inline void override_topology(const topology* topology) noexcept {
+			detail::topology_override.store(topology);
+		}
+
+		// returns the number of NUMA nodes of the machine
+		inline size_t num_nodes() noexcept {
+			if (const topology* topology = detail::topology_override.load(std::memory_order_acquire))
+				return topology->num_nodes;
+			static const size_t num_nodes = detail::detect_num_nodes();
+			return num_nodes;
+		}
+
+		// returns the NUMA node of the cpu the calling thread runs on
+		inline size_t current_node() noexcept {
+			if (const topology* topology = detail::topology_override.load(std::memory_order_acquire))
+				return topology->current_node();
+#if defined(PROTO_HAS_GETCPU)
+			unsigned cpu = 0;
+			unsigned node = 0;
+			if (::getcpu(&cpu, &node) == 0)
+				return node;
+#elif defined(__linux__)
+			unsigned cpu = 0;
+			unsigned node = 0;
+			if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+				return node;
+#endif
+			return 0;
+		}
+
+	}
+
+	namespace detail {
+
+		// Keeps a replica of the value for each NUMA node, emissions load the 
+		// replica of the node they run on so reader bookkeeping such as 
+		// reference and reader counts is not shared between nodes. Writers 
+		// update every replica. The replicas and their snapshots are all 
+		// allocated by the writing thread and are not bound to their node,
+		// they only sit on separate cache lines, which keeps readers of 
+		// different nodes from invalidating each other's lines but leaves 
+		// the memory itself wherever the writer's node placed it.
+		template <class T, class Cell>
+		class replicated_cell {
+			struct alignas(64) replica {
+				Cell cell;
+			};
+		public:
+			using snapshot = typename Cell::snapshot;
+
+			replicated_cell()
+				: m_num_replicas(numa::num_nodes() ? numa::num_nodes() : 1)
+				, m_replicas(std::make_unique<replica[]>(m_num_replicas)) {}
+
+			replicated_cell(replicated_cell&& other)
+				: replicated_cell() 
+			{
+				swap(other);
+			}
+
+			snapshot load() const {
+				return m_replicas[numa::current_node() % m_num_replicas].cell.load();
+			}
+
+			template <class Update>
+			void update(Update&& update) {
+				for (size_t i = 0; i < m_num_replicas; ++i)
+					m_replicas[i].cell.update(update);
+			}
+
+			void swap(replicated_cell& other) noexcept {
+				using std::swap;
+				swap(m_num_replicas, other.m_num_replicas);
+				swap(m_replicas, other.m_replicas);
+			}
+
+		private:
+			size_t m_num_replicas;
+			std::unique_ptr<replica[]> m_replicas;
+		};
+
+	}
+
+	// Threading policies decide how a signal may be shared between threads. 
+	// Slots of concurrent signals are stored in immutable snapshots that
+	// emissions iterate over without holding locks, connections and 
+	// disconnections publish a new snapshot. The policy mutex serializes the
+	// publication and the snapshot cell decides how readers acquire one.
+
+	// A signal that is only used by one thread at a time, emission iterates 
+	// over the slots directly.
+	struct single_threaded {
+		using mutex_type = detail::null_mutex;
+
+		static constexpr size_t inline_capacity = 0;
+	};
+
+	// A single threaded signal that stores its first N slots inside the 
+	// signal object and only allocates once more slots are connected.
+	template <size_t N>
+	struct inline_single_threaded {
+		using mutex_type = detail::null_mutex;
+
+		static constexpr size_t inline_capacity = N;
+	};
+
+	// A single threaded signal that stores up to Capacity slots inside the 
+	// signal object and constructs their callables in place in SlotBytes of
+	// storage each. It never allocates once constructed: connecting to a
+	// full signal returns an empty connection, and a callable that does not
+	// fit into SlotBytes fails to compile.
+	template <size_t Capacity, size_t SlotBytes>
+	struct fixed_single_threaded {
+		using mutex_type = detail::null_mutex;
+
+		static constexpr size_t slot_capacity = Capacity;
+		static constexpr size_t slot_bytes = SlotBytes;
+	};
+
+	// A single threaded signal that stores its slots in pages of PageSlots
+	// slots each, which are allocated one at a time and never move. Signals
+	// with a very large number of slots connect without reallocating their
+	// slots, and the pages of disconnected slots are freed.
+	template <size_t PageSlots>
+	struct paged_single_threaded {
+		using mutex_type = detail::null_mutex;
+
+		static constexpr size_t page_slots = PageSlots;
+	};
+
+	// Readers acquire the snapshot under a spin lock.
+	struct spin_locked {
+		using mutex_type = std::mutex;
+
+		template <class T>
+		using snapshot_cell = detail::locked_cell<T, detail::spin_mutex>;
+	};
+
+	// Readers acquire the snapshot under the shared side of a reader-writer lock.
+	struct shared_locked {
+		using mutex_type = std::mutex;
+
+		template <class T>
+		using snapshot_cell = detail::locked_cell<T, std::shared_mutex>;
+	};
+
+	// Readers acquire the snapshot without locking, replaced snapshots are
+	// reclaimed once no reader can reference them.
+	struct rcu_snapshots {
+		using mutex_type = std::mutex;
+
+		template <class T>
+		using snapshot_cell = detail::rcu_cell<T>;
+	};
+
+	// Keeps a replica of the snapshots of ThreadingPolicy for each NUMA node,
+	// so emitting from every core of a multi socket machine does not bounce
+	// cache lines across the interconnect. Connecting and disconnecting 
+	// update every replica. The replicas are not allocated in node-local
+	// memory, only the false sharing between nodes is avoided.
+	template <class ThreadingPolicy = rcu_snapshots>
+	struct numa_replicated {
+		using mutex_type = typename ThreadingPolicy::mutex_type;
+
+		template <class T>
+		using snapshot_cell = detail::replicated_cell<T, 
+			typename ThreadingPolicy::template snapshot_cell<T>>;
+	};
+
+	template <class Callable, 
+		class ThreadingPolicy = single_threaded, 
+		class ExceptionPolicy = propagate_exceptions>
+	class basic_signal;
+
+	template <class Callable, class ExceptionPolicy = propagate_exceptions>
+	using signal = basic_signal<Callable, single_threaded, ExceptionPolicy>;
+
+	template <class Callable, size_t N, class ExceptionPolicy = propagate_exceptions>
+	using small_signal = basic_signal<Callable, inline_single_threaded<N>, ExceptionPolicy>;
+
+	template <class Callable, size_t Capacity, size_t SlotBytes = 32, class ExceptionPolicy = propagate_exceptions>
+	using fixed_signal = basic_signal<Callable, fixed_single_threaded<Capacity, SlotBytes>, ExceptionPolicy>;
+
+	template <class Callable, size_t PageSlots = 256, class ExceptionPolicy = propagate_exceptions>
+	using paged_signal = basic_signal<Callable, paged_single_threaded<PageSlots>, ExceptionPolicy>;
+
+	template <class Signature>
+	class delegate;
+
+	template <class Signature, class Key, class ExceptionPolicy = propagate_exceptions>
+	class routed_signal;
 
 	namespace detail {
 		
@@ -58,28 +595,66 @@ namespace proto {
 		};
 
 
-		template <class Callable>
+		// a callback that a proxy runs once it has released its lock
+		using deferred_hook = std::shared_ptr<const std::function<void()>>;
+
+		// How a proxy reaches into the signal it refers to, each signal type 
+		// provides one, so proxies only depend on the mutex of the signal.
+		// disconnect returns the hook that losing the slot calls for.
+		struct signal_access {
+			bool(*connected)(const void* signal, uint64_t slot_id);
+			deferred_hook(*disconnect)(void* signal, uint64_t slot_id);
+		};
+
+		template <class Mutex>
 		class signal_proxy final : public signal_proxy_base {
+			using lock_type = std::lock_guard<Mutex>;
 		public:
-			signal_proxy(signal<Callable>* signal)
-				: m_signal(signal) {}
+			signal_proxy(void* signal, const signal_access& access) noexcept
+				: m_signal(signal)
+				, m_access(access) {}
 
 			bool connected(uint64_t slot_id) const override {
-				return m_signal && m_signal->connected(slot_id);
+				lock_type lock(m_mutex);
+				return m_signal && m_access.connected(m_signal, slot_id);
 			}
 
+			// the hook runs without the lock, so that it may use the 
+			// connections of the signal
 			void disconnect(uint64_t slot_id) const override {
-				assert(connected(slot_id));
-				m_signal->disconnect(slot_id);
+				deferred_hook hook;
+				{
+					lock_type lock(m_mutex);
+					if (m_signal)
+						hook = m_access.disconnect(m_signal, slot_id);
+				}
+				if (hook && *hook)
+					(*hook)();
 			}
 
-		private:
-			friend class signal<Callable>;
+			void* signal() const noexcept {
+				return m_signal;
+			}
+
+			void rebind(void* signal) noexcept {
+				lock_type lock(m_mutex);
+				m_signal = signal;
+			}
 
-			signal<Callable>* m_signal;
+		private:
+			mutable Mutex m_mutex;
+			void* m_signal;
+			const signal_access& m_access;
 		};
+
+		// the call count of slots that were connected without a limit
+		inline constexpr uint64_t unlimited_calls = ~uint64_t(0);
 	}
 
+	// the interest mask of slots connected without one, masked emissions
+	// invoke them for any event
+	inline constexpr uint64_t all_events = ~uint64_t(0);
+
 	class connection final {
 	public:
 
@@ -109,7 +684,7 @@ namespace proto {
 
 		void close() {
 			std::shared_ptr<detail::signal_proxy_base> signal_proxy(m_signal_proxy.lock());
-			if (signal_proxy && signal_proxy->connected(m_slot_id))
+			if (signal_proxy)
 				signal_proxy->disconnect(m_slot_id);
 			m_signal_proxy.reset();
 		}
@@ -169,175 +744,2683 @@ namespace proto {
 		}
 
 		size_t num_connections() const {
-			return std::count_if(m_conns.begin(), m_conns.end(), 
-				[](const connection& conn) { return conn.valid(); });
+			size_t count = 0;
+			for (const connection& conn : m_conns)
+				count += conn.valid();
+			return count;
 		}
 
 	private:
-		template <typename>
-		friend class signal;
+		template <class, class, class>
+		friend class basic_signal;
+
+		template <class>
+		friend class delegate;
+
+		template <class, class, class>
+		friend class routed_signal;
 
 		void append(connection&& conn) {
 			m_conns.emplace_back(std::move(conn));
 		}
 
-		std::vector<connection> m_conns;
-	};
-
-	namespace detail {
-
-		template <class It, class = std::void_t<>>
-		struct is_iterator : std::false_type {};
-
-		template <class It>
-		struct is_iterator<It, std::void_t<typename std::iterator_traits<It>::iterator_category>>
-			: std::true_type {};
+		// binds a member function of obj to the signature Ret(Args...), 
+		// connects it through connect and keeps the connection in obj. 
+		// Void signatures drop the value the member function returns.
+		template <class Ret, class... Args, class T, class Func, class Connect>
+		static void connect_member(T* obj, Func func, Connect&& connect) {
+			static_assert(std::is_base_of_v<receiver, T>);
 
-		template <class It>
-		constexpr bool is_iterator_v = is_iterator<It>::value;
+			connection conn = connect([obj, func](Args... args) -> Ret {
+				return static_cast<Ret>((obj->*func)(args...));
+			});
+			static_cast<receiver*>(obj)->append(std::move(conn));
+		}
 
-	}
+		std::vector<connection> m_conns;
+	};
 
-	template <class Ret, class... Args>
-	class signal<Ret(Args...)> final {
-		using signal_proxy_type = detail::signal_proxy<Ret(Args...)>;
-		friend class signal_proxy_type;
+	// A vector that stores up to N elements inline before it spills over into
+	// heap storage. Used to gather slot return values without allocating.
+	template <class T, size_t N>
+	class small_vector {
 	public:
+		using value_type = T;
+		using size_type = size_t;
+		using difference_type = std::ptrdiff_t;
+		using reference = T&;
+		using const_reference = const T&;
+		using pointer = T*;
+		using const_pointer = const T*;
+		using iterator = T*;
+		using const_iterator = const T*;
+
+		small_vector() noexcept
+			: m_data(inline_data())
+			, m_size(0)
+			, m_capacity(N) {}
+
+		small_vector(const small_vector& other)
+			: small_vector() 
+		{
+			reserve(other.size());
+			for (const T& value : other)
+				emplace_back(value);
+		}
 
-		using slot_type = std::function<Ret(Args...)>;
-
-		signal()
-			: m_next_slot_id(0)
-			, m_slots()
-			, m_signal_proxy(std::make_shared<signal_proxy_type>(this)) 
-		{}
-		
-		signal(signal&& other)
-			: m_next_slot_id(other.m_next_slot_id)
-			, m_slots(std::move(other.m_slots))
-			, m_signal_proxy(std::move(other.m_signal_proxy))
+		small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+			: small_vector() 
 		{
-			rebind_signal_proxy();
+			steal(other);
 		}
 
-		signal& operator=(signal&& other) {
+		small_vector& operator=(const small_vector& other) {
 			if (this != std::addressof(other)) {
-				m_next_slot_id = other.m_next_slot_id;
-				m_slots = std::move(other.m_slots);
-				m_signal_proxy = std::move(other.m_signal_proxy);
-				rebind_signal_proxy();
+				clear();
+				reserve(other.size());
+				for (const T& value : other)
+					emplace_back(value);
 			}
 			return *this;
 		}
 
-		// connects a free-function or lambda function
-		connection connect(slot_type slot) {
-			uint64_t slot_id = m_next_slot_id++;
-			m_slots.emplace(slot_id, slot);
-			return connection(slot_id, m_signal_proxy);
+		small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+			if (this != std::addressof(other)) {
+				clear();
+				release();
+				steal(other);
+			}
+			return *this;
 		}
 
-		// connects a non-const member function to the signal
-		template <class T>
-		void connect(T* obj, Ret(T::*func)(Args...)) {
-			static_assert(std::is_base_of_v<receiver, T>);
-
-			// construct the slot connection
-			connection conn = connect([obj, func](Args... args) {
-				return (obj->*func)(args...);
-			});
-
-			// append it to the receiver's list of slots
-			static_cast<receiver*>(obj)->append(std::move(conn));
+		~small_vector() {
+			clear();
+			release();
 		}
 
-		// connects a const member function
-		template <class T>
-		void connect(T* obj, Ret(T::*func)(Args...) const) {
-			static_assert(std::is_base_of_v<receiver, T>);
+		template <class... Params>
+		T& emplace_back(Params&&... params) {
+			if (m_size == m_capacity)
+				reallocate(m_capacity ? 2 * m_capacity : 1);
+			T* value = ::new (static_cast<void*>(m_data + m_size)) T(std::forward<Params>(params)...);
+			++m_size;
+			return *value;
+		}
 
-			// construct the slot connection
-			connection conn = connect([obj, func](Args... args) {
-				return (obj->*func)(args...);
-			});
+		void push_back(const T& value) {
+			emplace_back(value);
+		}
 
-			// append it to the receiver's list of slots
-			static_cast<receiver*>(obj)->append(std::move(conn));
+		void push_back(T&& value) {
+			emplace_back(std::move(value));
 		}
 
-		// invokes each connected slot and outputs its return value
-		// into the collection given by dest
-		template <class OutIt>
-		std::enable_if_t<detail::is_iterator_v<OutIt>> 
-		collect(OutIt dest, Args... args) {
-			static_assert(!std::is_same_v<Ret, void>, 
-				"Cannot collect from void returning callbacks.");
+		void pop_back() noexcept {
+			assert(!empty());
+			m_data[--m_size].~T();
+		}
 
-			for (auto&[_, slot] : m_slots)
-				*dest++ = slot(args...);
+		void reserve(size_type capacity) {
+			if (capacity > m_capacity)
+				reallocate(capacity);
 		}
 
-		// invokes each slot attached to *this
-		void operator()(Args... args) {
-			emit(args...);
+		// moves the elements back inside *this if they fit, otherwise into
+		// heap storage of their exact size
+		void shrink_to_fit() {
+			if (is_inline() || m_size == m_capacity)
+				return;
+			if (m_size > N) {
+				reallocate(m_size);
+				return;
+			}
+			T* data = m_data;
+			const size_type capacity = m_capacity;
+			m_data = inline_data();
+			m_capacity = N;
+			for (size_type i = 0; i < m_size; ++i) {
+				::new (static_cast<void*>(m_data + i)) T(std::move_if_noexcept(data[i]));
+				data[i].~T();
+			}
+			std::allocator<T>().deallocate(data, capacity);
 		}
 
-		// invokes each slot attached to *this
-		void emit(Args... args) {
-			for (auto&[_, slot] : m_slots)
-				slot(args...);
+		void clear() noexcept {
+			while (m_size)
+				pop_back();
 		}
 
-		// checks if *this contains any slot
-		bool empty() const noexcept {
-			return m_slots.empty();
+		// checks if the elements are stored inside *this
+		bool is_inline() const noexcept {
+			return m_data == inline_data();
 		}
 
-		// returns the number of slots attached to *this
-		size_t size() const noexcept {
-			return m_slots.size();
+		bool empty() const noexcept { return m_size == 0; }
+		size_type size() const noexcept { return m_size; }
+		size_type capacity() const noexcept { return m_capacity; }
+
+		T* data() noexcept { return m_data; }
+		const T* data() const noexcept { return m_data; }
+
+		T& operator[](size_type i) noexcept { return m_data[i]; }
+		const T& operator[](size_type i) const noexcept { return m_data[i]; }
+
+		T& front() noexcept { return m_data[0]; }
+		const T& front() const noexcept { return m_data[0]; }
+		T& back() noexcept { return m_data[m_size - 1]; }
+		const T& back() const noexcept { return m_data[m_size - 1]; }
+
+		iterator begin() noexcept { return m_data; }
+		const_iterator begin() const noexcept { return m_data; }
+		iterator end() noexcept { return m_data + m_size; }
+		const_iterator end() const noexcept { return m_data + m_size; }
+
+	private:
+		T* inline_data() noexcept {
+			return reinterpret_cast<T*>(m_inline);
 		}
 
-		// disconnects all slots
-		void clear() noexcept {
-			m_next_slot_id = 0;
-			m_slots.clear();
+		const T* inline_data() const noexcept {
+			return reinterpret_cast<const T*>(m_inline);
 		}
 
-		void swap(signal& other) {
-			if (this != std::addressof(other)) {
-				using std::swap;
-				swap(m_next_slot_id, other.m_next_slot_id);
-				swap(m_slots, other.m_slots);
-				swap(m_signal_proxy, other.m_signal_proxy);
-				rebind_signal_proxy();
-				other.rebind_signal_proxy();
+		void reallocate(size_type capacity) {
+			T* data = std::allocator<T>().allocate(capacity);
+			for (size_type i = 0; i < m_size; ++i) {
+				::new (static_cast<void*>(data + i)) T(std::move_if_noexcept(m_data[i]));
+				m_data[i].~T();
 			}
+			release();
+			m_data = data;
+			m_capacity = capacity;
 		}
 
-	private:
-		
-		signal(const signal&) = delete;
-		signal& operator=(const signal&) = delete;
-		
-		void rebind_signal_proxy() {
-			using std::static_pointer_cast;
-			static_pointer_cast<signal_proxy_type>(m_signal_proxy)->m_signal = this;
+		// frees heap storage, the elements must already be destroyed
+		void release() noexcept {
+			if (!is_inline())
+				std::allocator<T>().deallocate(m_data, m_capacity);
+			m_data = inline_data();
+			m_capacity = N;
 		}
 
-		bool connected(uint64_t slot_id) const {
-			return m_slots.find(slot_id) != m_slots.end();
+		// takes the elements of other, *this must be empty and use its inline
+		// storage, which it keeps if other does, and other is left empty
+		void steal(small_vector& other) {
+			if (other.is_inline()) {
+				for (T& value : other)
+					emplace_back(std::move(value));
+				other.clear();
+			}
+			else {
+				m_data = std::exchange(other.m_data, other.inline_data());
+				m_size = std::exchange(other.m_size, 0);
+				m_capacity = std::exchange(other.m_capacity, N);
+			}
 		}
 
-		void disconnect(uint64_t slot_id) {
-			auto it = m_slots.find(slot_id);
-			assert(it != m_slots.end());
-			m_slots.erase(it);
-		}
+		T* m_data;
+		size_type m_size;
+		size_type m_capacity;
+		alignas(T) unsigned char m_inline[(N ? N : 1) * sizeof(T)];
+	};
 
-		uint64_t m_next_slot_id;
-		std::map<uint64_t, slot_type> m_slots;
+	namespace detail {
+
+		template <class It, class = std::void_t<>>
+		struct is_iterator : std::false_type {};
+
+		template <class It>
+		struct is_iterator<It, std::void_t<typename std::iterator_traits<It>::iterator_category>>
+			: std::true_type {};
+
+		template <class It>
+		inline constexpr bool is_iterator_v = is_iterator<It>::value;
+
+		template <class T>
+		struct is_tuple : std::false_type {};
+
+		template <class... Ts>
+		struct is_tuple<std::tuple<Ts...>> : std::true_type {};
+
+		template <class T>
+		inline constexpr bool is_tuple_v = is_tuple<std::remove_cv_t<T>>::value;
+
+		// whether F connects as a plain function pointer, which covers free
+		// functions and captureless lambdas
+		template <class F, class Signature>
+		inline constexpr bool is_function_slot_v = std::is_convertible_v<F, std::add_pointer_t<Signature>>
+			&& !std::is_same_v<std::decay_t<F>, std::nullptr_t>;
+
+		// The hot half of a slot: the emission loop only touches a dense array
+		// of these, 16 bytes each, everything else about a slot lives in a 
+		// parallel array of cold records.
+		// Plain function pointers are stored as the function itself with a
+		// null context and are called directly, without a thunk.
+		template <class Signature>
+		struct slot_invoker;
+
+		template <class Ret, class... Args>
+		struct slot_invoker<Ret(Args...)> {
+			using function_type = Ret(*)(Args...);
+
+			// slots of void signatures may return a value, which is dropped
+			template <class F>
+			static Ret call(void* context, Args... args) {
+				if constexpr (std::is_void_v<Ret>)
+					(void)(*static_cast<F*>(context))(std::forward<Args>(args)...);
+				else
+					return (*static_cast<F*>(context))(std::forward<Args>(args)...);
+			}
+
+			template <class F>
+			static slot_invoker bind(F& callable) noexcept {
+				return { &call<F>, std::addressof(callable) };
+			}
+
+			static slot_invoker bind(function_type function) noexcept {
+				return { function_cast<Ret(*)(void*, Args...)>(function), nullptr };
+			}
+
+			template <class... Params>
+			Ret operator()(Params&&... params) const {
+				if (context)
+					return function(context, std::forward<Params>(params)...);
+				return function_cast<function_type>(function)(std::forward<Params>(params)...);
+			}
+
+			// function pointers round trip through any other function pointer
+			// type, void(*)() marks the cast as intended
+			template <class To, class From>
+			static To function_cast(From function) noexcept {
+				return reinterpret_cast<To>(reinterpret_cast<void(*)()>(function));
+			}
+
+			// disconnected slots are marked by a null function
+			explicit operator bool() const noexcept {
+				return function != nullptr;
+			}
+
+			Ret(*function)(void*, Args...);
+			void* context;
+		};
+
+		// Owns a single callable along with the invoker bound to it. Nothrow
+		// movable callables of at most BufferSize bytes are stored inline, 
+		// other callables on the heap, and plain function pointers need no 
+		// storage. A disabled box keeps its callable but has a null invoker.
+		template <class Signature, size_t BufferSize>
+		class callable_box;
+
+		template <class Ret, class... Args, size_t BufferSize>
+		class callable_box<Ret(Args...), BufferSize> {
+			using invoker = slot_invoker<Ret(Args...)>;
+
+			// moves the callable of from into to and destroys the original,
+			// or only destroys it if to is null
+			using manager = void(*)(callable_box& from, callable_box* to) noexcept;
+
+			template <class F>
+			static constexpr bool stored_inline = sizeof(F) <= BufferSize 
+				&& alignof(F) <= alignof(std::max_align_t)
+				&& std::is_nothrow_move_constructible_v<F>;
+
+			template <class F>
+			static void manage_inline(callable_box& from, callable_box* to) noexcept {
+				F* callable = static_cast<F*>(from.m_slot.context);
+				if (to) {
+					to->m_slot.function = from.m_slot.function;
+					to->m_slot.context = ::new (static_cast<void*>(to->m_buffer)) F(std::move(*callable));
+				}
+				callable->~F();
+			}
+
+			template <class F>
+			static void manage_heap(callable_box& from, callable_box* to) noexcept {
+				if (to)
+					to->m_slot = from.m_slot;
+				else
+					delete static_cast<F*>(from.m_slot.context);
+			}
+		public:
+			callable_box() noexcept
+				: m_slot{ nullptr, nullptr }
+				, m_manage(nullptr) {}
+
+			callable_box(callable_box&& other) noexcept
+				: callable_box()
+			{
+				take(other);
+			}
+
+			callable_box& operator=(callable_box&& other) noexcept {
+				if (this != std::addressof(other)) {
+					reset();
+					take(other);
+				}
+				return *this;
+			}
+
+			~callable_box() {
+				reset();
+			}
+
+			// constructs a callable of type F from params
+			template <class F, class... Params>
+			void emplace(Params&&... params) {
+				reset();
+				if constexpr (stored_inline<F>) {
+					m_slot = invoker::bind(*::new (static_cast<void*>(m_buffer)) F(std::forward<Params>(params)...));
+					m_manage = &manage_inline<F>;
+				}
+				else {
+					m_slot = invoker::bind(*new F(std::forward<Params>(params)...));
+					m_manage = &manage_heap<F>;
+				}
+			}
+
+			void emplace_function(typename invoker::function_type function) noexcept {
+				reset();
+				m_slot = invoker::bind(function);
+			}
+
+			void disable() noexcept {
+				m_slot.function = nullptr;
+			}
+
+			void reset() noexcept {
+				if (m_manage)
+					m_manage(*this, nullptr);
+				m_slot = { nullptr, nullptr };
+				m_manage = nullptr;
+			}
+
+			const invoker& slot() const noexcept {
+				return m_slot;
+			}
+
+		private:
+			// takes the callable of other, *this must be empty
+			void take(callable_box& other) noexcept {
+				if (other.m_manage)
+					other.m_manage(other, this);
+				else
+					m_slot = other.m_slot;
+				m_manage = std::exchange(other.m_manage, nullptr);
+				other.m_slot = { nullptr, nullptr };
+			}
+
+			invoker m_slot;
+			manager m_manage;
+			alignas(std::max_align_t) unsigned char m_buffer[BufferSize ? BufferSize : 1];
+		};
+
+		// the storage of a slot, which holds callables up to the size of 
+		// four pointers inline
+		template <class Signature>
+		using slot_box = callable_box<Signature, 4 * sizeof(void*)>;
+
+		// stores a callable into a slot box, free functions and captureless
+		// lambdas as plain function pointers. A null function becomes an 
+		// empty std::function, which throws once it is invoked.
+		template <class Ret, class... Args, class F>
+		void emplace_slot(slot_box<Ret(Args...)>& box, F&& callable) {
+			if constexpr (is_function_slot_v<F, Ret(Args...)>) {
+				Ret(*pointer)(Args...) = std::forward<F>(callable);
+				if (pointer)
+					box.emplace_function(pointer);
+				else
+					box.template emplace<std::function<Ret(Args...)>>();
+			}
+			else {
+				box.template emplace<std::decay_t<F>>(std::forward<F>(callable));
+			}
+		}
+
+		// the number of elements in [first, last) if it can be known 
+		// without consuming the range, otherwise zero
+		template <class It>
+		size_t distance_hint(It first, It last) {
+			if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>)
+				return static_cast<size_t>(std::distance(first, last));
+			else
+				return 0;
+		}
+
+		// Slot stores hold the slots of a signal under ascending ids, which 
+		// are never reused, and implement the reentrancy rules of emission:
+		//  - a slot disconnected mid emission is not invoked afterwards
+		//  - a slot connected mid emission is first invoked by the next emission
+		// A visitor that returns a bool ends the traversal by returning false.
+
+		// returned by stores that cannot hold another slot
+		inline constexpr uint64_t invalid_slot_id = ~uint64_t(0);
+
+		// the first slot in [first, last) whose id, as returned by id_of, is
+		// not less than slot_id
+		template <class It, class IdOf>
+		It lower_bound(It first, It last, uint64_t slot_id, IdOf id_of) {
+			auto count = last - first;
+			while (count > 0) {
+				auto step = count / 2;
+				It it = first + step;
+				if (id_of(*it) < slot_id) {
+					first = it + 1;
+					count -= step + 1;
+				}
+				else {
+					count = step;
+				}
+			}
+			return first;
+		}
+
+		template <class Visitor, class Slot>
+		bool visit_slot(Visitor& visit, Slot& slot) {
+			if constexpr (std::is_same_v<decltype(visit(slot)), bool>)
+				return visit(slot);
+			else
+				return visit(slot), true;
+		}
+
+		// passes the index of each of the count masks that shares a bit with
+		// event_mask to visit, in ascending order until visit returns false.
+		// Blocks of masks without a match are skipped with a single vector
+		// test, masks are reread once their block matches, as visit may
+		// clear them.
+		template <class Visit>
+		void scan_masks(const uint64_t* masks, size_t count, uint64_t event_mask, Visit&& visit) {
+			size_t i = 0;
+#if defined(PROTO_HAS_AVX2)
+			const __m256i events = _mm256_set1_epi64x(static_cast<long long>(event_mask));
+			for (; i + 16 <= count; i += 16) {
+				const __m256i* block = reinterpret_cast<const __m256i*>(masks + i);
+				const __m256i any = _mm256_or_si256(
+					_mm256_or_si256(_mm256_loadu_si256(block), _mm256_loadu_si256(block + 1)),
+					_mm256_or_si256(_mm256_loadu_si256(block + 2), _mm256_loadu_si256(block + 3)));
+				if (_mm256_testz_si256(any, events))
+					continue;
+				for (size_t j = i; j < i + 16; ++j) {
+					if ((masks[j] & event_mask) && !visit(j))
+						return;
+				}
+			}
+#elif defined(PROTO_HAS_SSE2)
+			const __m128i events = _mm_set1_epi64x(static_cast<long long>(event_mask));
+			for (; i + 8 <= count; i += 8) {
+				const __m128i* block = reinterpret_cast<const __m128i*>(masks + i);
+				const __m128i any = _mm_and_si128(events, _mm_or_si128(
+					_mm_or_si128(_mm_loadu_si128(block), _mm_loadu_si128(block + 1)),
+					_mm_or_si128(_mm_loadu_si128(block + 2), _mm_loadu_si128(block + 3))));
+				if (_mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128())) == 0xffff)
+					continue;
+				for (size_t j = i; j < i + 8; ++j) {
+					if ((masks[j] & event_mask) && !visit(j))
+						return;
+				}
+			}
+#endif
+			for (; i < count; ++i) {
+				if ((masks[i] & event_mask) && !visit(i))
+					return;
+			}
+		}
+
+		// Concurrent store, emissions iterate over a snapshot of the slots. 
+		// Slot records are shared between snapshots and disconnection clears
+		// their connected flag. An emission only checks the flags once a 
+		// disconnection has happened since it acquired its snapshot.
+		template <class Signature, class ThreadingPolicy, class = void>
+		class slot_store {
+			using invoker = slot_invoker<Signature>;
+
+			struct slot_record {
+				explicit slot_record(uint64_t slot_id, uint64_t calls = unlimited_calls) noexcept
+					: id(slot_id)
+					, connected(true)
+					, calls_left(calls) {}
+
+				const uint64_t id;
+				std::atomic<bool> connected;
+				std::atomic<uint64_t> calls_left;
+				slot_box<Signature> slot;
+			};
+
+			// masks stays empty while every slot has all_events as its 
+			// interest mask, owner disconnects the slots with a limited 
+			// number of calls
+			struct slot_table {
+				std::vector<invoker> invokers;
+				std::vector<std::shared_ptr<slot_record>> records;
+				std::vector<uint64_t> masks;
+				size_t num_counted = 0;
+				const signal_proxy_base* owner = nullptr;
+			};
+
+			using snapshot_cell = typename ThreadingPolicy::template snapshot_cell<slot_table>;
+			using write_lock = std::lock_guard<typename ThreadingPolicy::mutex_type>;
+		public:
+			static constexpr bool inline_callables = false;
+
+			slot_store()
+				: m_next_id(0)
+				, m_num_disconnections(0) {}
+
+			slot_store(slot_store&& other)
+				: m_next_id(other.m_next_id.load())
+				, m_num_disconnections(0)
+				, m_slots(std::move(other.m_slots)) {}
+
+			slot_store& operator=(slot_store&& other) {
+				slot_store(std::move(other)).swap(*this);
+				return *this;
+			}
+
+			// constructs a callable of type F from params in a new slot
+			template <class F, class... Params>
+			uint64_t emplace(Params&&... params) {
+				write_lock lock(m_mutex);
+				auto record = std::make_shared<slot_record>(m_next_id);
+				record->slot.template emplace<F>(std::forward<Params>(params)...);
+				return append(std::move(record), all_events);
+			}
+
+			template <class F>
+			uint64_t insert(F&& callable, uint64_t mask = all_events) {
+				write_lock lock(m_mutex);
+				auto record = std::make_shared<slot_record>(m_next_id);
+				emplace_slot(record->slot, std::forward<F>(callable));
+				return append(std::move(record), mask);
+			}
+
+			// inserts a callable that is disconnected through owner right 
+			// before the last of its calls runs
+			template <class F>
+			uint64_t insert_counted(F&& callable, uint64_t calls, const signal_proxy_base* owner) {
+				write_lock lock(m_mutex);
+				auto record = std::make_shared<slot_record>(m_next_id, calls);
+				emplace_slot(record->slot, std::forward<F>(callable));
+				return append(std::move(record), all_events, owner);
+			}
+
+			// inserts the callables of [first, last) with a single update of
+			// the snapshot, either all of them or none, and passes their ids 
+			// to inserted
+			template <class It, class Inserted>
+			void insert_range(It first, It last, Inserted&& inserted) {
+				write_lock lock(m_mutex);
+				std::vector<std::shared_ptr<slot_record>> records;
+				records.reserve(distance_hint(first, last));
+				const uint64_t first_id = m_next_id;
+				for (uint64_t slot_id = first_id; first != last; ++first, ++slot_id) {
+					records.push_back(std::make_shared<slot_record>(slot_id));
+					emplace_slot(records.back()->slot, *first);
+				}
+				m_slots.update([&](slot_table& slots) {
+					slots.invokers.reserve(slots.invokers.size() + records.size());
+					slots.records.reserve(slots.records.size() + records.size());
+					if (!slots.masks.empty())
+						slots.masks.resize(slots.masks.size() + records.size(), all_events);
+					for (const auto& record : records) {
+						slots.invokers.push_back(record->slot.slot());
+						slots.records.push_back(record);
+					}
+				});
+				m_next_id = first_id + records.size();
+				for (const auto& record : records)
+					inserted(record->id);
+			}
+
+			// snapshots are copied at their size whenever they are updated,
+			// which leaves nothing to reserve or release
+			void reserve(size_t) noexcept {}
+			void shrink_to_fit() noexcept {}
+
+			bool erase(uint64_t slot_id) {
+				write_lock lock(m_mutex);
+				bool erased = false;
+				m_slots.update([&](slot_table& slots) {
+					auto it = find(slots, slot_id);
+					if (it != slots.records.end()) {
+						(*it)->connected.store(false);
+						if ((*it)->calls_left.load() != unlimited_calls)
+							--slots.num_counted;
+						const auto i = it - slots.records.begin();
+						slots.invokers.erase(slots.invokers.begin() + i);
+						if (!slots.masks.empty())
+							slots.masks.erase(slots.masks.begin() + i);
+						slots.records.erase(it);
+						erased = true;
+					}
+				});
+				if (erased)
+					m_num_disconnections.fetch_add(1, std::memory_order_release);
+				return erased;
+			}
+
+			// returns the number of slots disconnected
+			size_t clear() {
+				write_lock lock(m_mutex);
+				size_t count = 0;
+				m_slots.update([&](slot_table& slots) {
+					count = slots.records.size();
+					for (auto& record : slots.records)
+						record->connected.store(false);
+					slots.invokers.clear();
+					slots.records.clear();
+					slots.masks.clear();
+					slots.num_counted = 0;
+				});
+				m_num_disconnections.fetch_add(1, std::memory_order_release);
+				return count;
+			}
+
+			bool contains(uint64_t slot_id) const {
+				auto slots = m_slots.load();
+				auto it = find(*slots, slot_id);
+				return it != slots->records.end() && (*it)->connected.load();
+			}
+
+			size_t size() const {
+				return m_slots.load()->records.size();
+			}
+
+			// the id bound of traversals that begin now
+			uint64_t end_id() const noexcept {
+				return m_next_id.load();
+			}
+
+			template <class Visitor>
+			void for_each(Visitor&& visit) const {
+				// a disconnection that completes before this point is already
+				// reflected by the snapshot
+				const uint64_t num_disconnections = m_num_disconnections.load(std::memory_order_acquire);
+				auto slots = m_slots.load();
+				const size_t count = slots->invokers.size();
+				const bool counted = slots->num_counted != 0;
+				for (size_t i = 0; i < count; ++i) {
+					if (m_num_disconnections.load(std::memory_order_acquire) != num_disconnections
+						&& !slots->records[i]->connected.load(std::memory_order_acquire))
+						continue;
+					if (counted && !claim_call(*slots, i))
+						continue;
+					if (!visit_slot(visit, slots->invokers[i]))
+						return;
+				}
+			}
+
+			// visits the slots whose interest mask shares a bit with 
+			// event_mask, under the rules of for_each
+			template <class Visitor>
+			void for_each_masked(uint64_t event_mask, Visitor&& visit) const {
+				const uint64_t num_disconnections = m_num_disconnections.load(std::memory_order_acquire);
+				auto slots = m_slots.load();
+				if (slots->masks.empty()) {
+					if (event_mask)
+						for_each(visit);
+					return;
+				}
+				const bool counted = slots->num_counted != 0;
+				scan_masks(slots->masks.data(), slots->masks.size(), event_mask, [&](size_t i) {
+					if (m_num_disconnections.load(std::memory_order_acquire) != num_disconnections
+						&& !slots->records[i]->connected.load(std::memory_order_acquire))
+						return true;
+					if (counted && !claim_call(*slots, i))
+						return true;
+					return visit_slot(visit, slots->invokers[i]);
+				});
+			}
+
+			// visits the first slot with an id in [slot_id, last_id) and 
+			// stores its id into slot_id, returns false if there is none
+			template <class Visitor>
+			bool visit_from(uint64_t& slot_id, uint64_t last_id, Visitor&& visit) const {
+				auto slots = m_slots.load();
+				for (auto it = lower_bound(slots->records, slot_id); it != slots->records.end() && (*it)->id < last_id; ++it) {
+					const size_t i = it - slots->records.begin();
+					if ((*it)->connected.load() && (slots->num_counted == 0 || claim_call(*slots, i))) {
+						slot_id = (*it)->id;
+						visit(slots->invokers[i]);
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void swap(slot_store& other) {
+				uint64_t next_id = m_next_id.load();
+				m_next_id.store(other.m_next_id.load());
+				other.m_next_id.store(next_id);
+				m_slots.swap(other.m_slots);
+			}
+
+		private:
+			uint64_t append(std::shared_ptr<slot_record> record, uint64_t mask, const signal_proxy_base* owner = nullptr) {
+				const uint64_t slot_id = m_next_id;
+				const bool counted = record->calls_left.load(std::memory_order_relaxed) != unlimited_calls;
+				m_slots.update([&](slot_table& slots) {
+					slots.records.reserve(slots.records.size() + 1);
+					const bool masked = mask != all_events || !slots.masks.empty();
+					if (masked) {
+						slots.masks.reserve(slots.records.size() + 1);
+						slots.masks.resize(slots.records.size(), all_events);
+					}
+					slots.invokers.push_back(record->slot.slot());
+					slots.records.push_back(record);
+					if (masked)
+						slots.masks.push_back(mask);
+					if (counted) {
+						++slots.num_counted;
+						slots.owner = owner;
+					}
+				});
+				m_next_id = slot_id + 1;
+				return slot_id;
+			}
+
+			// takes one of the calls left to the slot at index i, the taker
+			// of the last call disconnects the slot before it runs, returns
+			// false if no call is left
+			static bool claim_call(const slot_table& slots, size_t i) {
+				slot_record& record = *slots.records[i];
+				uint64_t calls = record.calls_left.load(std::memory_order_relaxed);
+				if (calls == unlimited_calls)
+					return true;
+				do {
+					if (calls == 0)
+						return false;
+				} while (!record.calls_left.compare_exchange_weak(calls, calls - 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+				if (calls == 1)
+					slots.owner->disconnect(record.id);
+				return true;
+			}
+
+			template <class Records>
+			static auto lower_bound(Records& records, uint64_t slot_id) {
+				return detail::lower_bound(records.begin(), records.end(), slot_id,
+					[](const auto& record) { return record->id; });
+			}
+
+			template <class Table>
+			static auto find(Table& slots, uint64_t slot_id) {
+				auto it = lower_bound(slots.records, slot_id);
+				return it != slots.records.end() && (*it)->id == slot_id ? it : slots.records.end();
+			}
+
+			std::atomic<uint64_t> m_next_id;
+			std::atomic<uint64_t> m_num_disconnections;
+			snapshot_cell m_slots;
+			typename ThreadingPolicy::mutex_type m_mutex;
+		};
+
+		// Single threaded store, emissions iterate over the slots directly. 
+		// While an emission is in progress the slot arrays never change shape:
+		// disconnected slots are left behind as tombstones, and slots that
+		// are connected wait in a pending list until the outermost emission 
+		// ends. A slot that is running is therefore never moved or destroyed.
+		// The first inline_capacity slots are stored inside the store itself.
+		template <class Ret, class... Args, class ThreadingPolicy>
+		class slot_store<Ret(Args...), ThreadingPolicy, std::void_t<decltype(ThreadingPolicy::inline_capacity)>> {
+			static constexpr size_t inline_capacity = ThreadingPolicy::inline_capacity;
+
+			using invoker = slot_invoker<Ret(Args...)>;
+
+			struct slot_record {
+				uint64_t id;
+				uint64_t mask;
+				uint64_t calls_left;
+				slot_box<Ret(Args...)> slot;
+			};
+
+			template <class T>
+			using slot_array = std::conditional_t<inline_capacity == 0, 
+				std::vector<T>, small_vector<T, inline_capacity>>;
+
+			class emission_scope {
+			public:
+				explicit emission_scope(slot_store& store) noexcept
+					: m_store(store) 
+				{
+					++m_store.m_emission_depth;
+				}
+
+				emission_scope(const emission_scope&) = delete;
+				emission_scope& operator=(const emission_scope&) = delete;
+
+				~emission_scope() {
+					if (--m_store.m_emission_depth == 0)
+						m_store.settle();
+				}
+
+			private:
+				slot_store& m_store;
+			};
+		public:
+			static constexpr bool inline_callables = false;
+
+			slot_store()
+				: m_invokers()
+				, m_records()
+				, m_masks()
+				, m_pending()
+				, m_next_id(0)
+				, m_num_tombstones(0)
+				, m_num_counted(0)
+				, m_owner(nullptr)
+				, m_emission_depth(0) {}
+
+			slot_store(slot_store&& other)
+				: m_invokers(std::move(other.m_invokers))
+				, m_records(std::move(other.m_records))
+				, m_masks(std::move(other.m_masks))
+				, m_pending(std::move(other.m_pending))
+				, m_next_id(other.m_next_id)
+				, m_num_tombstones(std::exchange(other.m_num_tombstones, 0))
+				, m_num_counted(std::exchange(other.m_num_counted, 0))
+				, m_owner(other.m_owner)
+				, m_emission_depth(0) 
+			{
+				rebind_moved();
+			}
+
+			slot_store& operator=(slot_store&& other) {
+				if (this != std::addressof(other)) {
+					m_invokers = std::move(other.m_invokers);
+					m_records = std::move(other.m_records);
+					m_masks = std::move(other.m_masks);
+					m_pending = std::move(other.m_pending);
+					m_next_id = other.m_next_id;
+					m_num_tombstones = std::exchange(other.m_num_tombstones, 0);
+					m_num_counted = std::exchange(other.m_num_counted, 0);
+					m_owner = other.m_owner;
+					rebind_moved();
+				}
+				return *this;
+			}
+
+			// constructs a callable of type F from params in a new slot, the
+			// record is built before the store changes and then moved into
+			// place, which relocates inline callables and keeps the others
+			template <class F, class... Params>
+			uint64_t emplace(Params&&... params) {
+				slot_record record{ m_next_id, all_events, unlimited_calls, {} };
+				record.slot.template emplace<F>(std::forward<Params>(params)...);
+				return insert(std::move(record));
+			}
+
+			template <class F>
+			uint64_t insert(F&& callable, uint64_t mask = all_events) {
+				slot_record record{ m_next_id, mask, unlimited_calls, {} };
+				emplace_slot(record.slot, std::forward<F>(callable));
+				return insert(std::move(record));
+			}
+
+			// inserts a callable that is disconnected through owner right 
+			// before the last of its calls runs
+			template <class F>
+			uint64_t insert_counted(F&& callable, uint64_t calls, const signal_proxy_base* owner) {
+				slot_record record{ m_next_id, all_events, calls, {} };
+				emplace_slot(record.slot, std::forward<F>(callable));
+				const uint64_t slot_id = insert(std::move(record));
+				m_owner = owner;
+				++m_num_counted;
+				return slot_id;
+			}
+
+			// inserts the callables of [first, last) after growing the slot
+			// arrays once, and passes their ids to inserted
+			template <class It, class Inserted>
+			void insert_range(It first, It last, Inserted&& inserted) {
+				const size_t count = distance_hint(first, last);
+				if (m_emission_depth || !m_pending.empty())
+					m_pending.reserve(m_pending.size() + count);
+				else
+					reserve(m_records.size() + count);
+				for (; first != last; ++first)
+					inserted(insert(*first));
+			}
+
+			// makes room for capacity slots, which is ignored mid emission as
+			// the slots must not move then
+			void reserve(size_t capacity) {
+				if (m_emission_depth || capacity <= m_records.capacity())
+					return;
+				m_invokers.reserve(capacity);
+				m_records.reserve(capacity);
+				if (!m_masks.empty())
+					m_masks.reserve(capacity);
+				rebind(0);
+			}
+
+			// removes the tombstones and releases unused capacity, which is 
+			// ignored mid emission
+			void shrink_to_fit() {
+				if (m_emission_depth)
+					return;
+				if (m_num_tombstones)
+					compact();
+				m_invokers.shrink_to_fit();
+				m_records.shrink_to_fit();
+				m_masks.shrink_to_fit();
+				m_pending.shrink_to_fit();
+				rebind(0);
+			}
+
+			bool erase(uint64_t slot_id) {
+				auto it = lower_bound(m_records, slot_id);
+				if (it != m_records.end() && it->id == slot_id) {
+					invoker& slot = m_invokers[it - m_records.begin()];
+					if (!slot)
+						return false;
+					slot.function = nullptr;
+					if (!m_masks.empty())
+						m_masks[it - m_records.begin()] = 0;
+					if (it->calls_left != unlimited_calls)
+						--m_num_counted;
+					++m_num_tombstones;
+					// the slot might be running, its destruction waits 
+					// until the outermost emission ends
+					if (!m_emission_depth) {
+						it->slot.reset();
+						if (2 * m_num_tombstones > m_records.size())
+							compact();
+					}
+					return true;
+				}
+
+				auto pending = lower_bound(m_pending, slot_id);
+				if (pending != m_pending.end() && pending->id == slot_id) {
+					if (pending->calls_left != unlimited_calls)
+						--m_num_counted;
+					m_pending.erase(pending);
+					return true;
+				}
+				return false;
+			}
+
+			// returns the number of slots disconnected
+			size_t clear() noexcept {
+				const size_t count = size();
+				if (m_emission_depth) {
+					for (invoker& slot : m_invokers)
+						slot.function = nullptr;
+					m_num_tombstones = m_invokers.size();
+				}
+				else {
+					m_invokers.clear();
+					m_records.clear();
+					m_masks.clear();
+					m_num_tombstones = 0;
+				}
+				m_pending.clear();
+				m_num_counted = 0;
+				return count;
+			}
+
+			bool contains(uint64_t slot_id) const {
+				auto it = lower_bound(m_records, slot_id);
+				if (it != m_records.end() && it->id == slot_id)
+					return bool(m_invokers[it - m_records.begin()]);
+				auto pending = lower_bound(m_pending, slot_id);
+				return pending != m_pending.end() && pending->id == slot_id;
+			}
+
+			size_t size() const noexcept {
+				return m_invokers.size() - m_num_tombstones + m_pending.size();
+			}
+
+			// the id bound of traversals that begin now, which excludes
+			// slots still pending
+			uint64_t end_id() const noexcept {
+				return m_pending.empty() ? m_next_id : m_pending.front().id;
+			}
+
+			template <class Visitor>
+			void for_each(Visitor&& visit) {
+				emission_scope scope(*this);
+				const invoker* slots = m_invokers.data();
+				const size_t count = m_invokers.size();
+				if (m_num_counted) {
+					for (size_t i = 0; i < count; ++i) {
+						if (slots[i] && !visit_counted(visit, i))
+							return;
+					}
+					return;
+				}
+				for (size_t i = 0; i < count; ++i) {
+					if (slots[i] && !visit_slot(visit, slots[i]))
+						return;
+				}
+			}
+
+			// visits the slots whose interest mask shares a bit with 
+			// event_mask, under the rules of for_each
+			template <class Visitor>
+			void for_each_masked(uint64_t event_mask, Visitor&& visit) {
+				if (m_masks.empty()) {
+					if (event_mask)
+						for_each(visit);
+					return;
+				}
+				emission_scope scope(*this);
+				const invoker* slots = m_invokers.data();
+				const bool counted = m_num_counted != 0;
+				scan_masks(m_masks.data(), m_masks.size(), event_mask, [&](size_t i) {
+					return !slots[i] || (counted ? visit_counted(visit, i) : visit_slot(visit, slots[i]));
+				});
+			}
+
+			// visits the first slot with an id in [slot_id, last_id) and 
+			// stores its id into slot_id, returns false if there is none
+			template <class Visitor>
+			bool visit_from(uint64_t& slot_id, uint64_t last_id, Visitor&& visit) {
+				for (auto it = lower_bound(m_records, slot_id); it != m_records.end() && it->id < last_id; ++it) {
+					const size_t i = it - m_records.begin();
+					if (m_invokers[i]) {
+						slot_id = it->id;
+						emission_scope scope(*this);
+						visit_counted(visit, i);
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void swap(slot_store& other) noexcept {
+				using std::swap;
+				swap(m_invokers, other.m_invokers);
+				swap(m_records, other.m_records);
+				swap(m_masks, other.m_masks);
+				swap(m_pending, other.m_pending);
+				swap(m_next_id, other.m_next_id);
+				swap(m_num_tombstones, other.m_num_tombstones);
+				swap(m_num_counted, other.m_num_counted);
+				swap(m_owner, other.m_owner);
+				rebind_moved();
+				other.rebind_moved();
+			}
+
+		private:
+			uint64_t insert(slot_record&& record) {
+				const uint64_t slot_id = record.id;
+				if (m_emission_depth || !m_pending.empty()) {
+					m_pending.push_back(std::move(record));
+					if (!m_emission_depth)
+						settle();
+				}
+				else {
+					append(std::move(record));
+				}
+				m_next_id = slot_id + 1;
+				return slot_id;
+			}
+
+			template <class Records>
+			static auto lower_bound(Records& records, uint64_t slot_id) {
+				return detail::lower_bound(records.begin(), records.end(), slot_id,
+					[](const slot_record& record) { return record.id; });
+			}
+
+			// visits the slot at index i, a slot about to run its last call 
+			// is disconnected first and runs through a copy of its invoker,
+			// as its callable stays alive until the emission ends
+			template <class Visitor>
+			bool visit_counted(Visitor& visit, size_t i) {
+				const invoker slot = m_invokers[i];
+				slot_record& record = m_records[i];
+				if (record.calls_left != unlimited_calls && --record.calls_left == 0)
+					m_owner->disconnect(record.id);
+				return visit_slot(visit, slot);
+			}
+
+			// the mask array is only allocated once a slot has an interest
+			// mask other than all_events
+			void append(slot_record&& record) {
+				if (m_records.size() == m_records.capacity()) {
+					const size_t capacity = m_records.capacity() ? 2 * m_records.capacity() : 4;
+					m_invokers.reserve(capacity);
+					m_records.reserve(capacity);
+					// the records have moved, and their invokers with them
+					rebind(0);
+				}
+				const bool masked = record.mask != all_events || !m_masks.empty();
+				if (masked) {
+					m_masks.reserve(m_records.capacity());
+					m_masks.resize(m_records.size(), all_events);
+				}
+				m_records.push_back(std::move(record));
+				m_invokers.push_back(m_records.back().slot.slot());
+				if (masked)
+					m_masks.push_back(m_records.back().mask);
+			}
+
+			// points the invokers from index first on at the callables of 
+			// their records, which leaves tombstones alone
+			void rebind(size_t first) noexcept {
+				for (size_t i = first; i < m_records.size(); ++i)
+					if (m_invokers[i])
+						m_invokers[i] = m_records[i].slot.slot();
+			}
+
+			// inline records move along with the store
+			void rebind_moved() noexcept {
+				if constexpr (inline_capacity != 0)
+					rebind(0);
+			}
+
+			// removes the tombstones
+			void compact() noexcept {
+				size_t count = 0;
+				for (size_t i = 0; i < m_records.size(); ++i) {
+					if (m_invokers[i]) {
+						if (count != i) {
+							m_records[count] = std::move(m_records[i]);
+							m_invokers[count] = m_invokers[i];
+							if (!m_masks.empty())
+								m_masks[count] = m_masks[i];
+						}
+						++count;
+					}
+				}
+				while (m_records.size() > count) {
+					m_records.pop_back();
+					m_invokers.pop_back();
+				}
+				if (!m_masks.empty())
+					m_masks.resize(count);
+				m_num_tombstones = 0;
+				rebind(0);
+			}
+
+			// runs once the outermost emission has ended, slots that cannot be
+			// moved out of the pending list for a lack of memory stay there 
+			// until the next attempt
+			void settle() noexcept {
+				if (m_num_tombstones)
+					compact();
+				size_t num_settled = 0;
+				try {
+					for (; num_settled < m_pending.size(); ++num_settled)
+						append(std::move(m_pending[num_settled]));
+				}
+				catch (...) {}
+				m_pending.erase(m_pending.begin(), m_pending.begin() + num_settled);
+			}
+
+			slot_array<invoker> m_invokers;
+			slot_array<slot_record> m_records;
+			// the interest masks of the slots, empty while every slot has 
+			// all_events
+			std::vector<uint64_t> m_masks;
+			std::vector<slot_record> m_pending;
+			uint64_t m_next_id;
+			size_t m_num_tombstones;
+			// the connected slots with a limited number of calls
+			size_t m_num_counted;
+			const signal_proxy_base* m_owner;
+			uint32_t m_emission_depth;
+		};
+
+		// Paged store, slots live in pages of page_slots slots each that are
+		// reached through a page directory, and never move once connected. 
+		// Connecting fills the last page or adds a new one, disconnecting
+		// leaves a tombstone behind whose callable is destroyed once no 
+		// emission is in progress, and full pages without a connected slot
+		// are freed at that point. Emissions scan the pages one after 
+		// another and only visit the slots connected before the outermost
+		// emission began.
+		template <class Ret, class... Args, class ThreadingPolicy>
+		class slot_store<Ret(Args...), ThreadingPolicy, std::void_t<decltype(ThreadingPolicy::page_slots)>> {
+			static constexpr size_t page_slots = ThreadingPolicy::page_slots;
+			static_assert(page_slots > 0, "Paged signals need pages of at least one slot.");
+
+			using invoker = slot_invoker<Ret(Args...)>;
+
+			// the slots of a page have consecutive ids from first_id on
+			struct page {
+				explicit page(uint64_t slot_id) noexcept
+					: first_id(slot_id)
+					, size(0)
+					, num_live(0)
+					, num_retired(0) {}
+
+				uint64_t first_id;
+				size_t size;
+				// connected slots, including one under construction
+				size_t num_live;
+				// disconnected slots whose callables await destruction
+				size_t num_retired;
+				invoker invokers[page_slots];
+				uint64_t masks[page_slots];
+				uint64_t calls_left[page_slots];
+				slot_box<Ret(Args...)> slots[page_slots];
+			};
+
+			class emission_scope {
+			public:
+				explicit emission_scope(slot_store& store) noexcept
+					: m_store(store) 
+				{
+					if (m_store.m_emission_depth++ == 0)
+						m_store.m_end_id = m_store.m_next_id;
+				}
+
+				emission_scope(const emission_scope&) = delete;
+				emission_scope& operator=(const emission_scope&) = delete;
+
+				~emission_scope() {
+					if (--m_store.m_emission_depth == 0)
+						m_store.settle();
+				}
+
+			private:
+				slot_store& m_store;
+			};
+		public:
+			static constexpr bool inline_callables = false;
+
+			slot_store() noexcept
+				: m_next_id(0)
+				, m_end_id(0)
+				, m_size(0)
+				, m_num_retired(0)
+				, m_num_counted(0)
+				, m_owner(nullptr)
+				, m_emission_depth(0) {}
+
+			slot_store(slot_store&& other) noexcept
+				: m_pages(std::move(other.m_pages))
+				, m_next_id(other.m_next_id)
+				, m_end_id(other.m_next_id)
+				, m_size(std::exchange(other.m_size, 0))
+				, m_num_retired(std::exchange(other.m_num_retired, 0))
+				, m_num_counted(std::exchange(other.m_num_counted, 0))
+				, m_owner(other.m_owner)
+				, m_emission_depth(0) 
+			{
+				other.m_end_id = other.m_next_id;
+			}
+
+			slot_store& operator=(slot_store&& other) noexcept {
+				if (this != std::addressof(other)) {
+					m_pages = std::move(other.m_pages);
+					m_next_id = other.m_next_id;
+					m_end_id = other.m_next_id;
+					other.m_end_id = other.m_next_id;
+					m_size = std::exchange(other.m_size, 0);
+					m_num_retired = std::exchange(other.m_num_retired, 0);
+					m_num_counted = std::exchange(other.m_num_counted, 0);
+					m_owner = other.m_owner;
+				}
+				return *this;
+			}
+
+			template <class F>
+			uint64_t insert(F&& callable, uint64_t mask = all_events) {
+				return construct(mask, unlimited_calls, [&](slot_box<Ret(Args...)>& slot) {
+					emplace_slot(slot, std::forward<F>(callable));
+				});
+			}
+
+			// inserts a callable that is disconnected through owner right 
+			// before the last of its calls runs
+			template <class F>
+			uint64_t insert_counted(F&& callable, uint64_t calls, const signal_proxy_base* owner) {
+				const uint64_t slot_id = construct(all_events, calls, [&](slot_box<Ret(Args...)>& slot) {
+					emplace_slot(slot, std::forward<F>(callable));
+				});
+				m_owner = owner;
+				++m_num_counted;
+				return slot_id;
+			}
+
+			// constructs a callable of type F from params in a new slot
+			template <class F, class... Params>
+			uint64_t emplace(Params&&... params) {
+				return construct(all_events, unlimited_calls, [&](slot_box<Ret(Args...)>& slot) {
+					slot.template emplace<F>(std::forward<Params>(params)...);
+				});
+			}
+
+			template <class It, class Inserted>
+			void insert_range(It first, It last, Inserted&& inserted) {
+				reserve(m_size + distance_hint(first, last));
+				for (; first != last; ++first)
+					inserted(insert(*first));
+			}
+
+			bool erase(uint64_t slot_id) noexcept {
+				const size_t p = find_page(slot_id);
+				if (p == m_pages.size() || slot_id < m_pages[p]->first_id)
+					return false;
+				page& current = *m_pages[p];
+				const size_t i = static_cast<size_t>(slot_id - current.first_id);
+				if (!current.invokers[i])
+					return false;
+				current.invokers[i].function = nullptr;
+				current.masks[i] = 0;
+				if (current.calls_left[i] != unlimited_calls)
+					--m_num_counted;
+				--current.num_live;
+				--m_size;
+				// the slot might be running, its destruction waits until
+				// the outermost emission ends
+				if (m_emission_depth) {
+					++current.num_retired;
+					++m_num_retired;
+				}
+				else {
+					current.slots[i].reset();
+					if (!current.num_live && current.size == page_slots)
+						m_pages.erase(m_pages.begin() + p);
+				}
+				return true;
+			}
+
+			// returns the number of slots disconnected
+			size_t clear() noexcept {
+				const size_t count = m_size;
+				if (m_emission_depth) {
+					for (auto& current : m_pages) {
+						for (size_t i = 0; i < current->size; ++i) {
+							if (current->invokers[i]) {
+								current->invokers[i].function = nullptr;
+								--current->num_live;
+								++current->num_retired;
+								++m_num_retired;
+							}
+						}
+					}
+				}
+				else {
+					m_pages.clear();
+				}
+				m_size = 0;
+				m_num_counted = 0;
+				return count;
+			}
+
+			bool contains(uint64_t slot_id) const noexcept {
+				const size_t p = find_page(slot_id);
+				return p != m_pages.size() && slot_id >= m_pages[p]->first_id
+					&& bool(m_pages[p]->invokers[slot_id - m_pages[p]->first_id]);
+			}
+
+			size_t size() const noexcept {
+				return m_size;
+			}
+
+			// the id bound of traversals that begin now, which excludes 
+			// slots connected during the current emission
+			uint64_t end_id() const noexcept {
+				return m_emission_depth ? m_end_id : m_next_id;
+			}
+
+			template <class Visitor>
+			void for_each(Visitor&& visit) {
+				emission_scope scope(*this);
+				const uint64_t end_id = m_end_id;
+				// slots connected by the visited slots can add pages, which
+				// moves the directory but none of the pages
+				for (size_t p = 0; p < m_pages.size(); ++p) {
+					const page& current = *m_pages[p];
+					if (current.first_id >= end_id)
+						return;
+					const size_t count = end_id - current.first_id < current.size 
+						? static_cast<size_t>(end_id - current.first_id) : current.size;
+					for (size_t i = 0; i < count; ++i) {
+						if (current.invokers[i] && !(m_num_counted ? visit_counted(visit, p, i) : visit_slot(visit, current.invokers[i])))
+							return;
+					}
+				}
+			}
+
+			// visits the slots whose interest mask shares a bit with 
+			// event_mask, under the rules of for_each
+			template <class Visitor>
+			void for_each_masked(uint64_t event_mask, Visitor&& visit) {
+				emission_scope scope(*this);
+				const uint64_t end_id = m_end_id;
+				bool visiting = true;
+				for (size_t p = 0; visiting && p < m_pages.size(); ++p) {
+					const page& current = *m_pages[p];
+					if (current.first_id >= end_id)
+						return;
+					const size_t count = end_id - current.first_id < current.size 
+						? static_cast<size_t>(end_id - current.first_id) : current.size;
+					scan_masks(current.masks, count, event_mask, [&](size_t i) {
+						return visiting = !current.invokers[i] 
+							|| (m_num_counted ? visit_counted(visit, p, i) : visit_slot(visit, current.invokers[i]));
+					});
+				}
+			}
+
+			// visits the first slot with an id in [slot_id, last_id) and 
+			// stores its id into slot_id, returns false if there is none
+			template <class Visitor>
+			bool visit_from(uint64_t& slot_id, uint64_t last_id, Visitor&& visit) {
+				for (size_t p = find_page(slot_id); p < m_pages.size(); ++p) {
+					const page& current = *m_pages[p];
+					size_t i = slot_id > current.first_id ? static_cast<size_t>(slot_id - current.first_id) : 0;
+					for (; i < current.size && current.first_id + i < last_id; ++i) {
+						if (current.invokers[i]) {
+							slot_id = current.first_id + i;
+							emission_scope scope(*this);
+							visit_counted(visit, p, i);
+							return true;
+						}
+					}
+					if (current.first_id + i >= last_id)
+						return false;
+				}
+				return false;
+			}
+
+			// makes room in the page directory for the pages of capacity 
+			// slots, the pages themselves are allocated as they fill up
+			void reserve(size_t capacity) {
+				m_pages.reserve(m_pages.size() + (capacity + page_slots - 1) / page_slots);
+			}
+
+			// frees the pages without a connected slot, including a partly
+			// filled last page, and releases unused directory capacity. It is
+			// ignored mid emission.
+			void shrink_to_fit() {
+				if (m_emission_depth)
+					return;
+				release_pages(0);
+				m_pages.shrink_to_fit();
+			}
+
+			void swap(slot_store& other) noexcept {
+				using std::swap;
+				swap(m_pages, other.m_pages);
+				swap(m_next_id, other.m_next_id);
+				swap(m_end_id, other.m_end_id);
+				swap(m_size, other.m_size);
+				swap(m_num_retired, other.m_num_retired);
+				swap(m_num_counted, other.m_num_counted);
+				swap(m_owner, other.m_owner);
+			}
+
+		private:
+			// claims the next slot and constructs its callable with init, a
+			// slot whose construction throws is left behind as a tombstone
+			template <class Init>
+			uint64_t construct(uint64_t mask, uint64_t calls, Init&& init) {
+				if (m_pages.empty() || m_pages.back()->size == page_slots)
+					m_pages.push_back(std::make_unique<page>(m_next_id));
+				page& current = *m_pages.back();
+				const size_t i = current.size++;
+				current.invokers[i] = { nullptr, nullptr };
+				current.masks[i] = mask;
+				current.calls_left[i] = calls;
+				const uint64_t slot_id = m_next_id++;
+				++current.num_live;
+				try {
+					init(current.slots[i]);
+				}
+				catch (...) {
+					--current.num_live;
+					throw;
+				}
+				current.invokers[i] = current.slots[i].slot();
+				++m_size;
+				return slot_id;
+			}
+
+			// visits the slot at index i of page p, a slot about to run its 
+			// last call is disconnected first and runs through a copy of its
+			// invoker
+			template <class Visitor>
+			bool visit_counted(Visitor& visit, size_t p, size_t i) {
+				page& current = *m_pages[p];
+				const invoker slot = current.invokers[i];
+				uint64_t& calls_left = current.calls_left[i];
+				if (calls_left != unlimited_calls && --calls_left == 0)
+					m_owner->disconnect(current.first_id + i);
+				return visit_slot(visit, slot);
+			}
+
+			// the first page whose slots do not all precede slot_id
+			size_t find_page(uint64_t slot_id) const noexcept {
+				auto it = detail::lower_bound(m_pages.begin(), m_pages.end(), slot_id + 1,
+					[](const std::unique_ptr<page>& current) { return current->first_id + current->size; });
+				return static_cast<size_t>(it - m_pages.begin());
+			}
+
+			// frees the pages without a connected slot that hold at least 
+			// min_size slots
+			void release_pages(size_t min_size) noexcept {
+				size_t count = 0;
+				for (size_t p = 0; p < m_pages.size(); ++p) {
+					if (m_pages[p]->num_live || m_pages[p]->size < min_size)
+						m_pages[count++] = std::move(m_pages[p]);
+				}
+				while (m_pages.size() > count)
+					m_pages.pop_back();
+			}
+
+			// runs once the outermost emission has ended
+			void settle() noexcept {
+				if (!m_num_retired)
+					return;
+				for (auto& current : m_pages) {
+					if (!current->num_retired)
+						continue;
+					for (size_t i = 0; i < current->size; ++i) {
+						if (!current->invokers[i])
+							current->slots[i].reset();
+					}
+					current->num_retired = 0;
+				}
+				m_num_retired = 0;
+				release_pages(page_slots);
+			}
+
+			std::vector<std::unique_ptr<page>> m_pages;
+			uint64_t m_next_id;
+			uint64_t m_end_id;
+			size_t m_size;
+			size_t m_num_retired;
+			// the connected slots with a limited number of calls
+			size_t m_num_counted;
+			const signal_proxy_base* m_owner;
+			uint32_t m_emission_depth;
+		};
+
+		// Fixed store, all of its storage lives inside the store itself and 
+		// it never allocates. Callables are constructed in place in the slot
+		// records, and inserting into a full store returns invalid_slot_id.
+		// Emissions only visit the slots that were connected before the 
+		// outermost emission began, disconnections during an emission leave
+		// tombstones behind that are removed once it ends. Every operation
+		// takes at most linear time in the capacity.
+		template <class Ret, class... Args, class ThreadingPolicy>
+		class slot_store<Ret(Args...), ThreadingPolicy, std::void_t<decltype(ThreadingPolicy::slot_capacity)>> {
+			static constexpr size_t capacity = ThreadingPolicy::slot_capacity;
+			static constexpr size_t slot_bytes = ThreadingPolicy::slot_bytes;
+			static_assert(capacity > 0, "Fixed signals need a capacity of at least one slot.");
+
+			using invoker = slot_invoker<Ret(Args...)>;
+
+			// relocate and destroy are null for plain function slots, which
+			// leave storage unused
+			struct slot_record {
+				uint64_t id;
+				uint64_t calls_left;
+				void(*relocate)(void* from, void* to) noexcept;
+				void(*destroy)(void* callable) noexcept;
+				alignas(std::max_align_t) unsigned char storage[slot_bytes ? slot_bytes : 1];
+			};
+
+			template <class F>
+			static void relocate(void* from, void* to) noexcept {
+				::new (to) F(std::move(*static_cast<F*>(from)));
+				static_cast<F*>(from)->~F();
+			}
+
+			template <class F>
+			static void destroy(void* callable) noexcept {
+				static_cast<F*>(callable)->~F();
+			}
+
+			class emission_scope {
+			public:
+				explicit emission_scope(slot_store& store) noexcept
+					: m_store(store) 
+				{
+					++m_store.m_emission_depth;
+				}
+
+				emission_scope(const emission_scope&) = delete;
+				emission_scope& operator=(const emission_scope&) = delete;
+
+				~emission_scope() {
+					if (--m_store.m_emission_depth == 0)
+						m_store.compact();
+				}
+
+			private:
+				slot_store& m_store;
+			};
+		public:
+			static constexpr bool inline_callables = true;
+
+			slot_store() noexcept
+				: m_size(0)
+				, m_num_visible(0)
+				, m_num_tombstones(0)
+				, m_num_counted(0)
+				, m_owner(nullptr)
+				, m_next_id(0)
+				, m_emission_depth(0) {}
+
+			slot_store(slot_store&& other) noexcept
+				: slot_store()
+			{
+				take(other);
+			}
+
+			slot_store& operator=(slot_store&& other) noexcept {
+				if (this != std::addressof(other)) {
+					destroy_all();
+					take(other);
+				}
+				return *this;
+			}
+
+			~slot_store() {
+				destroy_all();
+			}
+
+			// constructs a callable of type F from params in a new slot
+			template <class F, class... Params>
+			uint64_t emplace(Params&&... params) {
+				return construct<F>(all_events, std::forward<Params>(params)...);
+			}
+
+			// stores free functions and captureless lambdas as plain function
+			// pointers, a null function is not inserted
+			template <class F>
+			uint64_t insert(F&& callable, uint64_t mask = all_events) {
+				if constexpr (is_function_slot_v<F, Ret(Args...)>) {
+					typename invoker::function_type function = std::forward<F>(callable);
+					if (!function || m_size == capacity)
+						return invalid_slot_id;
+					m_records[m_size].relocate = nullptr;
+					m_records[m_size].destroy = nullptr;
+					return append(invoker::bind(function), mask);
+				}
+				else {
+					return construct<std::decay_t<F>>(mask, std::forward<F>(callable));
+				}
+			}
+
+			// inserts a callable that is disconnected through owner right 
+			// before the last of its calls runs
+			template <class F>
+			uint64_t insert_counted(F&& callable, uint64_t calls, const signal_proxy_base* owner) {
+				const uint64_t slot_id = insert(std::forward<F>(callable));
+				if (slot_id != invalid_slot_id) {
+					m_records[m_size - 1].calls_left = calls;
+					m_owner = owner;
+					++m_num_counted;
+				}
+				return slot_id;
+			}
+
+			template <class It, class Inserted>
+			void insert_range(It first, It last, Inserted&& inserted) {
+				for (; first != last; ++first)
+					inserted(insert(*first));
+			}
+
+			// the capacity is fixed
+			void reserve(size_t) noexcept {}
+			void shrink_to_fit() noexcept {}
+
+			bool erase(uint64_t slot_id) noexcept {
+				const size_t i = find(slot_id);
+				if (i == m_size || !m_invokers[i])
+					return false;
+				m_invokers[i].function = nullptr;
+				m_masks[i] = 0;
+				if (m_records[i].calls_left != unlimited_calls)
+					--m_num_counted;
+				++m_num_tombstones;
+				// the slot might be running, its destruction waits until 
+				// the outermost emission ends
+				if (!m_emission_depth)
+					compact();
+				return true;
+			}
+
+			// returns the number of slots disconnected
+			size_t clear() noexcept {
+				const size_t count = size();
+				for (size_t i = 0; i < m_size; ++i)
+					m_invokers[i].function = nullptr;
+				m_num_tombstones = m_size;
+				m_num_counted = 0;
+				if (!m_emission_depth)
+					compact();
+				return count;
+			}
+
+			bool contains(uint64_t slot_id) const noexcept {
+				const size_t i = find(slot_id);
+				return i != m_size && m_invokers[i];
+			}
+
+			size_t size() const noexcept {
+				return m_size - m_num_tombstones;
+			}
+
+			// the id bound of traversals that begin now, which excludes
+			// slots connected during the current emission
+			uint64_t end_id() const noexcept {
+				return m_num_visible < m_size ? m_records[m_num_visible].id : m_next_id;
+			}
+
+			template <class Visitor>
+			void for_each(Visitor&& visit) {
+				emission_scope scope(*this);
+				const size_t count = m_num_visible;
+				for (size_t i = 0; i < count; ++i) {
+					if (m_invokers[i] && !(m_num_counted ? visit_counted(visit, i) : visit_slot(visit, m_invokers[i])))
+						return;
+				}
+			}
+
+			// visits the slots whose interest mask shares a bit with 
+			// event_mask, under the rules of for_each
+			template <class Visitor>
+			void for_each_masked(uint64_t event_mask, Visitor&& visit) {
+				emission_scope scope(*this);
+				scan_masks(m_masks, m_num_visible, event_mask, [&](size_t i) {
+					return !m_invokers[i] || (m_num_counted ? visit_counted(visit, i) : visit_slot(visit, m_invokers[i]));
+				});
+			}
+
+			// visits the first slot with an id in [slot_id, last_id) and 
+			// stores its id into slot_id, returns false if there is none
+			template <class Visitor>
+			bool visit_from(uint64_t& slot_id, uint64_t last_id, Visitor&& visit) {
+				for (size_t i = lower_bound(slot_id); i < m_size && m_records[i].id < last_id; ++i) {
+					if (m_invokers[i]) {
+						slot_id = m_records[i].id;
+						emission_scope scope(*this);
+						visit_counted(visit, i);
+						return true;
+					}
+				}
+				return false;
+			}
+
+			void swap(slot_store& other) noexcept {
+				slot_store temp(std::move(other));
+				other = std::move(*this);
+				*this = std::move(temp);
+			}
+
+		private:
+			template <class F, class... Params>
+			uint64_t construct(uint64_t mask, Params&&... params) {
+				static_assert(sizeof(F) <= slot_bytes,
+					"The callable does not fit into the slot storage of the fixed signal.");
+				static_assert(alignof(F) <= alignof(std::max_align_t),
+					"The callable is over-aligned for the slot storage of the fixed signal.");
+				static_assert(std::is_nothrow_move_constructible_v<F>,
+					"Callables of fixed signals must be nothrow move constructible.");
+
+				if (m_size == capacity)
+					return invalid_slot_id;
+				slot_record& record = m_records[m_size];
+				auto* target = ::new (static_cast<void*>(record.storage)) F(std::forward<Params>(params)...);
+				record.relocate = &relocate<F>;
+				record.destroy = &destroy<F>;
+				return append(invoker::bind(*target), mask);
+			}
+
+			uint64_t append(invoker slot, uint64_t mask) noexcept {
+				const uint64_t slot_id = m_next_id++;
+				m_records[m_size].id = slot_id;
+				m_records[m_size].calls_left = unlimited_calls;
+				m_invokers[m_size] = slot;
+				m_masks[m_size] = mask;
+				++m_size;
+				if (!m_emission_depth)
+					m_num_visible = m_size;
+				return slot_id;
+			}
+
+			// visits the slot at index i, a slot about to run its last call 
+			// is disconnected first and runs through a copy of its invoker
+			template <class Visitor>
+			bool visit_counted(Visitor& visit, size_t i) {
+				const invoker slot = m_invokers[i];
+				slot_record& record = m_records[i];
+				if (record.calls_left != unlimited_calls && --record.calls_left == 0)
+					m_owner->disconnect(record.id);
+				return visit_slot(visit, slot);
+			}
+
+			size_t lower_bound(uint64_t slot_id) const noexcept {
+				return detail::lower_bound(m_records, m_records + m_size, slot_id,
+					[](const slot_record& record) { return record.id; }) - m_records;
+			}
+
+			size_t find(uint64_t slot_id) const noexcept {
+				const size_t i = lower_bound(slot_id);
+				return i != m_size && m_records[i].id == slot_id ? i : m_size;
+			}
+
+			// moves a slot between records, which may belong to different stores
+			static void relocate_slot(slot_record& from, const invoker& from_slot, 
+				slot_record& to, invoker& to_slot) noexcept 
+			{
+				to.id = from.id;
+				to.calls_left = from.calls_left;
+				to.relocate = from.relocate;
+				to.destroy = from.destroy;
+				to_slot = from_slot;
+				if (from.relocate) {
+					from.relocate(from.storage, to.storage);
+					to_slot.context = to.storage;
+				}
+			}
+
+			// destroys the tombstones and makes every slot visible
+			void compact() noexcept {
+				size_t count = 0;
+				if (m_num_tombstones) {
+					for (size_t i = 0; i < m_size; ++i) {
+						slot_record& record = m_records[i];
+						if (!m_invokers[i]) {
+							if (record.destroy)
+								record.destroy(record.storage);
+						}
+						else {
+							if (count != i) {
+								relocate_slot(record, m_invokers[i], m_records[count], m_invokers[count]);
+								m_masks[count] = m_masks[i];
+							}
+							++count;
+						}
+					}
+					m_size = count;
+					m_num_tombstones = 0;
+				}
+				m_num_visible = m_size;
+			}
+
+			void destroy_all() noexcept {
+				for (size_t i = 0; i < m_size; ++i) {
+					if (m_records[i].destroy)
+						m_records[i].destroy(m_records[i].storage);
+				}
+				m_size = 0;
+				m_num_visible = 0;
+				m_num_tombstones = 0;
+				m_num_counted = 0;
+			}
+
+			// takes the slots of other, *this must be empty
+			void take(slot_store& other) noexcept {
+				for (size_t i = 0; i < other.m_size; ++i) {
+					relocate_slot(other.m_records[i], other.m_invokers[i], m_records[i], m_invokers[i]);
+					m_masks[i] = other.m_masks[i];
+				}
+				m_size = std::exchange(other.m_size, 0);
+				m_num_visible = std::exchange(other.m_num_visible, 0);
+				m_num_tombstones = std::exchange(other.m_num_tombstones, 0);
+				m_num_counted = std::exchange(other.m_num_counted, 0);
+				m_owner = other.m_owner;
+				m_next_id = other.m_next_id;
+			}
+
+			invoker m_invokers[capacity];
+			uint64_t m_masks[capacity];
+			slot_record m_records[capacity];
+			size_t m_size;
+			size_t m_num_visible;
+			size_t m_num_tombstones;
+			// the connected slots with a limited number of calls
+			size_t m_num_counted;
+			const signal_proxy_base* m_owner;
+			uint64_t m_next_id;
+			uint32_t m_emission_depth;
+		};
+
+	}
+
+	// A signal whose signature is noexcept emits without exception handling,
+	// a slot that throws calls std::terminate regardless of the policy.
+	template <class Ret, class... Args, bool Nothrow, class ThreadingPolicy, class ExceptionPolicy>
+	class basic_signal<Ret(Args...) noexcept(Nothrow), ThreadingPolicy, ExceptionPolicy> final {
+		using signal_proxy_type = detail::signal_proxy<typename ThreadingPolicy::mutex_type>;
+
+		static constexpr bool nothrow_emission = Nothrow || ExceptionPolicy::nothrow;
+
+		using exception_handler = std::conditional_t<nothrow_emission,
+			propagate_exceptions::handler, typename ExceptionPolicy::handler>;
+
+		using slot_store = detail::slot_store<Ret(Args...), ThreadingPolicy>;
+	public:
+
+		using threading_policy = ThreadingPolicy;
+		using exception_policy = ExceptionPolicy;
+
+		using slot_type = std::function<Ret(Args...)>;
+
+		// A single pass range over the values returned by the slots of a
+		// signal. A slot is invoked only once the range is advanced onto it,
+		// so a traversal that stops early leaves the remaining slots untouched.
+		// The range follows its signal through moves and swaps, and ends early
+		// if the signal is destroyed. Arguments bound to reference parameters
+		// must outlive the range. Under isolate_exceptions slots that throw 
+		// are skipped and the range raises their exceptions once it ends.
+		// The range is a member template only so that explicit instantiations
+		// of signals with void slots leave it alone.
+		template <class = Ret>
+		class basic_result_range {
+			using value_holder = std::conditional_t<std::is_reference_v<Ret>, 
+				std::remove_reference_t<Ret>*, std::optional<Ret>>;
+		public:
+
+			class iterator {
+			public:
+				using iterator_category = std::input_iterator_tag;
+				using value_type = std::decay_t<Ret>;
+				using difference_type = std::ptrdiff_t;
+				using pointer = std::remove_reference_t<Ret>*;
+				using reference = std::add_lvalue_reference_t<Ret>;
+
+				iterator() noexcept
+					: m_range(nullptr) {}
+
+				reference operator*() const {
+					return *m_range->m_value;
+				}
+
+				pointer operator->() const {
+					return std::addressof(**this);
+				}
+
+				iterator& operator++() noexcept(nothrow_emission) {
+					m_range->advance();
+					return *this;
+				}
+
+				void operator++(int) noexcept(nothrow_emission) {
+					++*this;
+				}
+
+				friend bool operator==(const iterator& lhs, const iterator& rhs) noexcept {
+					return lhs.at_end() == rhs.at_end();
+				}
+
+				friend bool operator!=(const iterator& lhs, const iterator& rhs) noexcept {
+					return !(lhs == rhs);
+				}
+
+			private:
+				friend class basic_result_range;
+
+				explicit iterator(basic_result_range* range) noexcept
+					: m_range(range) {}
+
+				bool at_end() const noexcept {
+					return !m_range || m_range->m_at_end;
+				}
+
+				basic_result_range* m_range;
+			};
+
+			// result ranges are not copy constructible or copy assignable
+			basic_result_range(const basic_result_range&) = delete;
+			basic_result_range& operator=(const basic_result_range&) = delete;
+
+			basic_result_range(basic_result_range&&) = default;
+			basic_result_range& operator=(basic_result_range&&) = default;
+
+			// invokes the first slot on the first call
+			iterator begin() noexcept(nothrow_emission) {
+				if (!m_started) {
+					m_started = true;
+					advance();
+				}
+				return iterator(this);
+			}
+
+			iterator end() noexcept {
+				return iterator();
+			}
+
+		private:
+			friend class basic_signal;
+
+			template <class... Params>
+			basic_result_range(const std::shared_ptr<detail::signal_proxy_base>& signal_proxy, 
+				uint64_t last_id, Params&&... args)
+				: m_signal_proxy(signal_proxy)
+				, m_next_id(0)
+				, m_last_id(last_id)
+				, m_args(std::forward<Params>(args)...)
+				, m_value()
+				, m_handler()
+				, m_started(false)
+				, m_at_end(false) {}
+
+			void advance() noexcept(nothrow_emission) {
+				m_value = value_holder();
+
+				// the signal is looked up again for each slot, as it may not
+				// have survived the previous one
+				while (basic_signal* signal = owner()) {
+					bool invoked = false;
+					bool found = signal->m_slots.visit_from(m_next_id, m_last_id, [&](auto& slot) {
+						++m_next_id;
+						auto invoke = [&slot](auto&... args) -> Ret { return slot(args...); };
+						invoked = m_handler.invoke([&] {
+							if constexpr (std::is_reference_v<Ret>)
+								m_value = std::addressof(std::apply(invoke, m_args));
+							else
+								m_value.emplace(std::apply(invoke, m_args));
+						});
+					});
+					if (!found)
+						break;
+					if (invoked)
+						return;
+				}
+				m_at_end = true;
+				m_handler.finish();
+			}
+
+			basic_signal* owner() const {
+				std::shared_ptr<detail::signal_proxy_base> signal_proxy(m_signal_proxy.lock());
+				return signal_proxy ? static_cast<basic_signal*>(static_cast<signal_proxy_type*>(signal_proxy.get())->signal()) : nullptr;
+			}
+
+			std::weak_ptr<detail::signal_proxy_base> m_signal_proxy;
+			uint64_t m_next_id;
+			uint64_t m_last_id;
+			std::tuple<Args...> m_args;
+			value_holder m_value;
+			exception_handler m_handler;
+			bool m_started;
+			bool m_at_end;
+		};
+
+		using result_range = basic_result_range<>;
+
+		basic_signal()
+			: m_slots()
+			, m_signal_proxy(make_signal_proxy()) 
+			, m_hooks()
+		{}
+		
+		// the connections follow the slots, and the moved-from signal gets 
+		// a fresh proxy, which counted slots connected to it later use to 
+		// disconnect themselves
+		basic_signal(basic_signal&& other)
+			: m_slots(std::move(other.m_slots))
+			, m_signal_proxy(std::exchange(other.m_signal_proxy, other.make_signal_proxy()))
+			, m_hooks(std::move(other.m_hooks))
+		{
+			rebind_signal_proxy(this);
+		}
+
+		basic_signal& operator=(basic_signal&& other) {
+			if (this != std::addressof(other)) {
+				rebind_signal_proxy(nullptr);
+				m_slots = std::move(other.m_slots);
+				m_signal_proxy = std::exchange(other.m_signal_proxy, other.make_signal_proxy());
+				m_hooks = std::move(other.m_hooks);
+				rebind_signal_proxy(this);
+			}
+			return *this;
+		}
+
+		~basic_signal() {
+			rebind_signal_proxy(nullptr);
+		}
+
+		// connects a free function, lambda or other callable, which is 
+		// forwarded into the slot storage without a std::function wrapper.
+		// Free functions and captureless lambdas are stored as plain 
+		// function pointers and called without type erasure.
+		template <class F, std::enable_if_t<std::is_invocable_r_v<Ret, std::decay_t<F>&, Args...>, int> = 0>
+		connection connect(F&& slot) {
+			return make_connection(m_slots.insert(std::forward<F>(slot)));
+		}
+
+		// connects a callable with a 64 bit interest mask, emit_masked only
+		// invokes it for events that share a bit with mask. Emissions 
+		// without an event mask invoke every slot.
+		template <class F, std::enable_if_t<std::is_invocable_r_v<Ret, std::decay_t<F>&, Args...>, int> = 0>
+		connection connect(F&& slot, uint64_t mask) {
+			return make_connection(m_slots.insert(std::forward<F>(slot), mask));
+		}
+
+		// connects a callable for at most n calls. The count lives in the
+		// slot record, and the emission that takes the last call
+		// disconnects the slot before it runs, so nested and concurrent
+		// emissions never exceed n calls. Nothing is connected for n = 0,
+		// and n = SIZE_MAX connects the callable without a limit.
+		template <class F, std::enable_if_t<std::is_invocable_r_v<Ret, std::decay_t<F>&, Args...>, int> = 0>
+		connection connect_n(F&& slot, size_t n) {
+			if (n == 0)
+				return connection();
+			if (n >= detail::unlimited_calls)
+				return connect(std::forward<F>(slot));
+			return make_connection(m_slots.insert_counted(std::forward<F>(slot), n, m_signal_proxy.get()));
+		}
+
+		// connects a callable for a single call
+		template <class F, std::enable_if_t<std::is_invocable_r_v<Ret, std::decay_t<F>&, Args...>, int> = 0>
+		connection connect_once(F&& slot) {
+			return connect_n(std::forward<F>(slot), 1);
+		}
+
+		// connects a callable of type F constructed in place from params
+		template <class F, class... Params>
+		connection emplace_connect(Params&&... params) {
+			static_assert(std::is_invocable_r_v<Ret, F&, Args...>,
+				"The slot type is not callable with the arguments of the signal.");
+			return make_connection(m_slots.template emplace<F>(std::forward<Params>(params)...));
+		}
+
+		// connects each callable of [first, last) and returns their 
+		// connections in the same order. The slot storage grows at most 
+		// once for ranges that can be measured up front, and concurrent
+		// signals publish all of the slots at once.
+		template <class It>
+		std::vector<connection> connect_range(It first, It last) {
+			static_assert(std::is_invocable_r_v<Ret, std::decay_t<decltype(*first)>&, Args...>,
+				"The range holds slots that are not callable with the arguments of the signal.");
+			std::vector<connection> connections;
+			connections.reserve(detail::distance_hint(first, last));
+			m_slots.insert_range(first, last, [&](uint64_t slot_id) {
+				connections.push_back(make_connection(slot_id));
+			});
+			return connections;
+		}
+
+		// connects a non-const member function to the signal
+		template <class T, class R, std::enable_if_t<std::is_void_v<Ret> || std::is_same_v<R, Ret>, int> = 0>
+		void connect(T* obj, R(T::*func)(Args...), uint64_t mask = all_events) {
+			receiver::connect_member<Ret, Args...>(obj, func, [this, mask](auto&& slot) {
+				return connect(std::move(slot), mask);
+			});
+		}
+
+		// connects a const member function
+		template <class T, class R, std::enable_if_t<std::is_void_v<Ret> || std::is_same_v<R, Ret>, int> = 0>
+		void connect(T* obj, R(T::*func)(Args...) const, uint64_t mask = all_events) {
+			receiver::connect_member<Ret, Args...>(obj, func, [this, mask](auto&& slot) {
+				return connect(std::move(slot), mask);
+			});
+		}
+
+		// invokes each connected slot and outputs its return value
+		// into the collection given by dest
+		template <class OutIt>
+		std::enable_if_t<detail::is_iterator_v<OutIt>> 
+		collect(OutIt dest, Args... args) noexcept(nothrow_emission) {
+			static_assert(!std::is_same_v<Ret, void>, 
+				"Cannot collect from void returning callbacks.");
+
+			exception_handler handler;
+			m_slots.for_each([&](auto& slot) {
+				handler.invoke([&] { *dest++ = slot(args...); });
+			});
+			handler.finish();
+		}
+
+		// invokes connected slots until the buffer [first, last) is full and
+		// returns the number of values written into it, slots that do not fit
+		// into the buffer are not invoked
+		template <class It>
+		std::enable_if_t<detail::is_iterator_v<It>, size_t>
+		collect_into(It first, It last, Args... args) noexcept(nothrow_emission) {
+			static_assert(!std::is_same_v<Ret, void>,
+				"Cannot collect from void returning callbacks.");
+
+			size_t count = 0;
+			if (first != last) {
+				exception_handler handler;
+				m_slots.for_each([&](auto& slot) {
+					if (handler.invoke([&] { *first = slot(args...); })) {
+						++count;
+						++first;
+					}
+					return first != last;
+				});
+				handler.finish();
+			}
+			return count;
+		}
+
+		// invokes each connected slot and returns their values in a vector
+		// that holds up to N values without allocating
+		template <size_t N>
+		small_vector<std::decay_t<Ret>, N> collect_small(Args... args) {
+			static_assert(!std::is_same_v<Ret, void>,
+				"Cannot collect from void returning callbacks.");
+
+			small_vector<std::decay_t<Ret>, N> values;
+			values.reserve(size());
+			exception_handler handler;
+			m_slots.for_each([&](auto& slot) {
+				handler.invoke([&] { values.emplace_back(slot(args...)); });
+			});
+			handler.finish();
+			return values;
+		}
+
+		// returns a lazy range over the slot return values, where each slot
+		// is invoked only once the range is advanced onto it
+		template <class R = Ret>
+		basic_result_range<R> results(Args... args) {
+			static_assert(!std::is_same_v<R, void>,
+				"Cannot collect from void returning callbacks.");
+
+			return basic_result_range<R>(m_signal_proxy, m_slots.end_id(), std::forward<Args>(args)...);
+		}
+
+		// invokes each slot attached to *this
+		void operator()(Args... args) noexcept(nothrow_emission) {
+			emit(args...);
+		}
+
+		// invokes each slot attached to *this
+		void emit(Args... args) noexcept(nothrow_emission) {
+			exception_handler handler;
+			m_slots.for_each([&](auto& slot) {
+				handler.invoke([&] { slot(args...); });
+			});
+			handler.finish();
+		}
+
+		// invokes each slot whose interest mask shares a bit with 
+		// event_mask, the masks are scanned without touching the slots
+		void emit_masked(uint64_t event_mask, Args... args) noexcept(nothrow_emission) {
+			exception_handler handler;
+			m_slots.for_each_masked(event_mask, [&](auto& slot) {
+				handler.invoke([&] { slot(args...); });
+			});
+			handler.finish();
+		}
+
+		// invokes each slot attached to *this with the arguments made by
+		// factory, which returns a std::tuple of them or, for signals of one
+		// parameter, the argument itself, which is passed whole even if it is
+		// a tuple. factory runs only once a slot is about to be invoked, at 
+		// most once, and the slots share what it made.
+		template <class Factory>
+		void emit_lazy(Factory&& factory) noexcept(nothrow_emission && std::is_nothrow_invocable_v<Factory&>) {
+			using payload_type = std::decay_t<std::invoke_result_t<Factory&>>;
+			constexpr bool unpack = sizeof...(Args) != 1;
+			static_assert(detail::is_tuple_v<payload_type> || !unpack,
+				"The factory must return a std::tuple of the arguments.");
+
+			std::optional<payload_type> payload;
+			exception_handler handler;
+			m_slots.for_each([&](auto& slot) {
+				if (!payload)
+					payload.emplace(factory());
+				handler.invoke([&] {
+					if constexpr (unpack)
+						std::apply([&](auto&... args) { slot(args...); }, *payload);
+					else
+						slot(*payload);
+				});
+			});
+			handler.finish();
+		}
+
+		// checks if *this contains any slot
+		bool empty() const noexcept {
+			return m_slots.size() == 0;
+		}
+
+		// returns the number of slots attached to *this
+		size_t size() const noexcept {
+			return m_slots.size();
+		}
+
+		// makes room for capacity slots so that connecting them does not
+		// grow the slot storage, it has no effect on concurrent and fixed
+		// signals or during an emission
+		void reserve(size_t capacity) {
+			m_slots.reserve(capacity);
+		}
+
+		// releases the storage of disconnected slots and unused capacity, 
+		// it has no effect on concurrent and fixed signals or during an
+		// emission
+		void shrink_to_fit() {
+			m_slots.shrink_to_fit();
+		}
+
+		// disconnects all slots
+		void clear() noexcept {
+			slots_removed(m_slots.clear());
+		}
+
+		// Sets the callback that runs whenever the signal goes from no slots
+		// to one, and the callback that runs whenever it goes from one slot
+		// to none, through a closed connection, a destroyed receiver or 
+		// clear. Producers can start and stop work that nobody observes 
+		// with them. The callbacks run on the thread that connected or 
+		// disconnected the slot, without any lock of the signal held, and 
+		// must not throw. Concurrent signals must set them before they are
+		// shared between threads.
+		void on_observed(std::function<void()> callback) {
+			hooks().on_observed = std::move(callback);
+		}
+
+		void on_unobserved(std::function<void()> callback) {
+			hooks().on_unobserved = std::move(callback);
+		}
+
+		void swap(basic_signal& other) {
+			if (this != std::addressof(other)) {
+				using std::swap;
+				m_slots.swap(other.m_slots);
+				swap(m_signal_proxy, other.m_signal_proxy);
+				swap(m_hooks, other.m_hooks);
+				rebind_signal_proxy(this);
+				other.rebind_signal_proxy(std::addressof(other));
+			}
+		}
+
+	private:
+		
+		basic_signal(const basic_signal&) = delete;
+		basic_signal& operator=(const basic_signal&) = delete;
+		
+		std::shared_ptr<detail::signal_proxy_base> make_signal_proxy() {
+			return std::make_shared<signal_proxy_type>(this, signal_access());
+		}
+
+		void rebind_signal_proxy(basic_signal* signal) noexcept {
+			if (m_signal_proxy)
+				static_cast<signal_proxy_type*>(m_signal_proxy.get())->rebind(signal);
+		}
+
+		static const detail::signal_access& signal_access() noexcept {
+			static constexpr detail::signal_access access = {
+				[](const void* signal, uint64_t slot_id) { return static_cast<const basic_signal*>(signal)->connected(slot_id); },
+				[](void* signal, uint64_t slot_id) { return static_cast<basic_signal*>(signal)->disconnect(slot_id); }
+			};
+			return access;
+		}
+
+		// the connection of a slot, or an empty one if the store was full
+		connection make_connection(uint64_t slot_id) noexcept {
+			if (slot_id == detail::invalid_slot_id)
+				return connection();
+			slots_added(1);
+			return connection(slot_id, m_signal_proxy);
+		}
+
+		// counts the slots for the observation callbacks once one is set
+		struct observation_hooks {
+			explicit observation_hooks(size_t count) noexcept
+				: num_slots(count) {}
+
+			std::function<void()> on_observed;
+			std::function<void()> on_unobserved;
+			std::atomic<size_t> num_slots;
+		};
+
+		observation_hooks& hooks() {
+			if (!m_hooks)
+				m_hooks = std::make_shared<observation_hooks>(m_slots.size());
+			return *m_hooks;
+		}
+
+		void slots_added(size_t count) noexcept {
+			if (m_hooks && count && m_hooks->num_slots.fetch_add(count) == 0 && m_hooks->on_observed)
+				m_hooks->on_observed();
+		}
+
+		void slots_removed(size_t count) noexcept {
+			if (m_hooks && count && m_hooks->num_slots.fetch_sub(count) == count && m_hooks->on_unobserved)
+				m_hooks->on_unobserved();
+		}
+
+		bool connected(uint64_t slot_id) const {
+			return m_slots.contains(slot_id);
+		}
+
+		// returns the unobserved hook if the slot was the last one, the 
+		// proxy runs it once it has released its lock
+		detail::deferred_hook disconnect(uint64_t slot_id) {
+			if (m_slots.erase(slot_id) && m_hooks && m_hooks->num_slots.fetch_sub(1) == 1)
+				return detail::deferred_hook(m_hooks, &m_hooks->on_unobserved);
+			return nullptr;
+		}
+
+		slot_store m_slots;
+		std::shared_ptr<detail::signal_proxy_base> m_signal_proxy;
+		// shared with the hooks that proxies run after their lock
+		std::shared_ptr<observation_hooks> m_hooks;
+	};
+
+	// A single callback with the lifetime safety of a signal slot: connecting
+	// a target returns a proto::connection, and connecting another target 
+	// replaces it. Invoking an empty delegate throws std::bad_function_call.
+	// A target that is disconnected or replaced while it runs is destroyed
+	// once the outermost invocation returns, and its replacement is first 
+	// invoked after that.
+	template <class Ret, class... Args>
+	class delegate<Ret(Args...)> final {
+		using signal_proxy_type = detail::signal_proxy<detail::null_mutex>;
+
+		using callable_box = detail::callable_box<Ret(Args...), 3 * sizeof(void*)>;
+
+		class invocation_scope {
+		public:
+			explicit invocation_scope(delegate& owner) noexcept
+				: m_owner(owner)
+			{
+				++m_owner.m_invocation_depth;
+			}
+
+			invocation_scope(const invocation_scope&) = delete;
+			invocation_scope& operator=(const invocation_scope&) = delete;
+
+			~invocation_scope() {
+				if (--m_owner.m_invocation_depth == 0)
+					m_owner.settle();
+			}
+
+		private:
+			delegate& m_owner;
+		};
+	public:
+
+		using threading_policy = single_threaded;
+		using result_type = Ret;
+
+		delegate() noexcept
+			: m_target()
+			, m_pending()
+			, m_slot_id(detail::invalid_slot_id)
+			, m_next_id(0)
+			, m_invocation_depth(0)
+			, m_signal_proxy() {}
+
+		delegate(delegate&& other) noexcept
+			: m_target(std::move(other.m_target))
+			, m_pending(std::move(other.m_pending))
+			, m_slot_id(std::exchange(other.m_slot_id, detail::invalid_slot_id))
+			, m_next_id(other.m_next_id)
+			, m_invocation_depth(0)
+			, m_signal_proxy(std::move(other.m_signal_proxy))
+		{
+			rebind_signal_proxy(this);
+		}
+
+		delegate& operator=(delegate&& other) noexcept {
+			if (this != std::addressof(other)) {
+				rebind_signal_proxy(nullptr);
+				m_target = std::move(other.m_target);
+				m_pending = std::move(other.m_pending);
+				m_slot_id = std::exchange(other.m_slot_id, detail::invalid_slot_id);
+				m_next_id = other.m_next_id;
+				m_signal_proxy = std::move(other.m_signal_proxy);
+				rebind_signal_proxy(this);
+			}
+			return *this;
+		}
+
+		~delegate() {
+			rebind_signal_proxy(nullptr);
+		}
+
+		// connects a free function, lambda or other callable, plain function
+		// pointers are called directly and small callables are stored inline
+		template <class F, std::enable_if_t<std::is_invocable_r_v<Ret, std::decay_t<F>&, Args...>, int> = 0>
+		connection connect(F&& target) {
+			callable_box box;
+			if constexpr (detail::is_function_slot_v<F, Ret(Args...)>) {
+				Ret(*pointer)(Args...) = std::forward<F>(target);
+				if (!pointer) {
+					clear();
+					return connection();
+				}
+				box.emplace_function(pointer);
+			}
+			else {
+				box.template emplace<std::decay_t<F>>(std::forward<F>(target));
+			}
+
+			if (m_invocation_depth) {
+				m_target.disable();
+				m_pending = std::move(box);
+			}
+			else {
+				m_target = std::move(box);
+			}
+			m_slot_id = m_next_id++;
+			return connection(m_slot_id, signal_proxy());
+		}
+
+		// connects a non-const member function
+		template <class T, class R, std::enable_if_t<std::is_void_v<Ret> || std::is_same_v<R, Ret>, int> = 0>
+		void connect(T* obj, R(T::*func)(Args...)) {
+			receiver::connect_member<Ret, Args...>(obj, func, [this](auto&& slot) {
+				return connect(std::move(slot));
+			});
+		}
+
+		// connects a const member function
+		template <class T, class R, std::enable_if_t<std::is_void_v<Ret> || std::is_same_v<R, Ret>, int> = 0>
+		void connect(T* obj, R(T::*func)(Args...) const) {
+			receiver::connect_member<Ret, Args...>(obj, func, [this](auto&& slot) {
+				return connect(std::move(slot));
+			});
+		}
+
+		// invokes the target and returns its value
+		Ret operator()(Args... args) {
+			const auto& target = m_target.slot();
+			if (!target)
+				throw std::bad_function_call();
+			invocation_scope scope(*this);
+			return target(std::forward<Args>(args)...);
+		}
+
+		// checks if *this has a target that can be invoked now, a target
+		// connected mid invocation only becomes invocable once the 
+		// outermost invocation returns
+		explicit operator bool() const noexcept {
+			return bool(m_target.slot());
+		}
+
+		bool empty() const noexcept {
+			return !m_target.slot();
+		}
+
+		// disconnects the target
+		void clear() noexcept {
+			disconnect(m_slot_id);
+		}
+
+		void swap(delegate& other) noexcept {
+			if (this != std::addressof(other)) {
+				delegate temp(std::move(other));
+				other = std::move(*this);
+				*this = std::move(temp);
+			}
+		}
+
+	private:
+
+		delegate(const delegate&) = delete;
+		delegate& operator=(const delegate&) = delete;
+
+		// the proxy is only allocated once a target is connected
+		const std::shared_ptr<detail::signal_proxy_base>& signal_proxy() {
+			if (!m_signal_proxy)
+				m_signal_proxy = std::make_shared<signal_proxy_type>(this, signal_access());
+			return m_signal_proxy;
+		}
+
+		void rebind_signal_proxy(delegate* owner) noexcept {
+			if (m_signal_proxy)
+				static_cast<signal_proxy_type*>(m_signal_proxy.get())->rebind(owner);
+		}
+
+		static const detail::signal_access& signal_access() noexcept {
+			static constexpr detail::signal_access access = {
+				[](const void* owner, uint64_t slot_id) { return static_cast<const delegate*>(owner)->connected(slot_id); },
+				[](void* owner, uint64_t slot_id) -> detail::deferred_hook { static_cast<delegate*>(owner)->disconnect(slot_id); return nullptr; }
+			};
+			return access;
+		}
+
+		bool connected(uint64_t slot_id) const noexcept {
+			return slot_id == m_slot_id && slot_id != detail::invalid_slot_id;
+		}
+
+		void disconnect(uint64_t slot_id) noexcept {
+			if (!connected(slot_id))
+				return;
+			m_slot_id = detail::invalid_slot_id;
+			if (m_invocation_depth) {
+				m_target.disable();
+				m_pending.reset();
+			}
+			else {
+				m_target.reset();
+			}
+		}
+
+		// runs once the outermost invocation has returned
+		void settle() noexcept {
+			if (!m_target.slot())
+				m_target.reset();
+			if (m_pending.slot())
+				m_target = std::move(m_pending);
+		}
+
+		callable_box m_target;
+		callable_box m_pending;
+		uint64_t m_slot_id;
+		uint64_t m_next_id;
+		uint32_t m_invocation_depth;
 		std::shared_ptr<detail::signal_proxy_base> m_signal_proxy;
 	};
 
-}
\ No newline at end of file
+}
+
+// Explicit instantiation hooks for signals that many translation units 
+// share. PROTO_EXTERN_SIGNAL(Sig) in a header keeps the including 
+// translation units from instantiating proto::signal<Sig> themselves, and
+// PROTO_INSTANTIATE_SIGNAL(Sig) in a single source file instantiates it.
+#define PROTO_EXTERN_SIGNAL(...) \
+	extern template class proto::detail::slot_store<__VA_ARGS__, proto::single_threaded>; \
+	extern template class proto::basic_signal<__VA_ARGS__, proto::single_threaded, proto::propagate_exceptions>
+
+#define PROTO_INSTANTIATE_SIGNAL(...) \
+	template class proto::detail::slot_store<__VA_ARGS__, proto::single_threaded>; \
+	template class proto::basic_signal<__VA_ARGS__, proto::single_threaded, proto::propagate_exceptions>
+
+// The proto_instances library instantiates the signals of these common 
+// signatures and defines PROTO_EXTERN_COMMON_SIGNALS for its users.
+#define PROTO_COMMON_SIGNALS(X) \
+	X(void()); \
+	X(void(bool)); \
+	X(void(int)); \
+	X(void(float)); \
+	X(void(double))
+
+#if defined(PROTO_EXTERN_COMMON_SIGNALS)
+PROTO_COMMON_SIGNALS(PROTO_EXTERN_SIGNAL);
+#endif
@@ -0,0 +1,418 @@
+// The routed signal of proto, which invokes only the slots whose key 
+// range holds the key of an emission. It lives apart from proto.hpp so 
+// that only its users pay for the algorithms its index needs.
+// Licensed under the MIT License https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include "proto.hpp"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace proto {
+
+	// an inclusive range of keys, as the slots of routed signals subscribe to
+	template <class Key>
+	struct key_range {
+		Key low;
+		Key high;
+	};
+
+	// A signal whose slots each subscribe to a range of keys, an emission 
+	// only invokes the slots whose range holds the key that the key 
+	// extractor of the signal computes from its arguments. The ranges are 
+	// indexed by a centered interval tree, so an emission finds the k slots 
+	// it invokes among n in O(log n + k), and invokes them in the order they
+	// were connected. The tree is rebuilt by the first emission after slots
+	// have been connected or disconnected. Slots connected during an 
+	// emission are first invoked by the next one, slots disconnected during
+	// an emission are not invoked afterwards and are destroyed once the 
+	// outermost emission ends. Keys are compared with operator<, a NaN key
+	// matches no slot.
+	template <class Ret, class... Args, bool Nothrow, class Key, class ExceptionPolicy>
+	class routed_signal<Ret(Args...) noexcept(Nothrow), Key, ExceptionPolicy> final {
+		using signal_proxy_type = detail::signal_proxy<detail::null_mutex>;
+
+		static constexpr bool nothrow_emission = Nothrow || ExceptionPolicy::nothrow;
+
+		using exception_handler = std::conditional_t<nothrow_emission,
+			propagate_exceptions::handler, typename ExceptionPolicy::handler>;
+
+		struct subscription {
+			subscription(uint64_t slot_id, const key_range<Key>& keys)
+				: id(slot_id)
+				, range(keys) {}
+
+			uint64_t id;
+			key_range<Key> range;
+			detail::slot_box<Ret(Args...)> slot;
+		};
+
+		// a node of the interval tree holds the ranges that contain its 
+		// center, at [first, last) of both m_by_low, sorted by ascending 
+		// low ends, and m_by_high, sorted by descending high ends
+		struct index_node {
+			Key center;
+			size_t first;
+			size_t last;
+			size_t left;
+			size_t right;
+		};
+
+		static constexpr size_t no_node = ~size_t(0);
+
+		class emission_scope {
+		public:
+			explicit emission_scope(routed_signal& signal) noexcept
+				: m_signal(signal)
+			{
+				++m_signal.m_emission_depth;
+			}
+
+			emission_scope(const emission_scope&) = delete;
+			emission_scope& operator=(const emission_scope&) = delete;
+
+			~emission_scope() {
+				if (--m_signal.m_emission_depth == 0)
+					m_signal.settle();
+			}
+
+		private:
+			routed_signal& m_signal;
+		};
+	public:
+
+		using threading_policy = single_threaded;
+		using exception_policy = ExceptionPolicy;
+		using key_type = Key;
+		using key_extractor = std::function<Key(const std::decay_t<Args>&...)>;
+
+		explicit routed_signal(key_extractor extract)
+			: m_extract(std::move(extract))
+			, m_root(no_node)
+			, m_next_id(0)
+			, m_num_retired(0)
+			, m_emission_depth(0)
+			, m_stale(false)
+			, m_signal_proxy() {}
+
+		routed_signal(routed_signal&& other) noexcept
+			: m_extract(std::move(other.m_extract))
+			, m_subscriptions(std::move(other.m_subscriptions))
+			, m_pending(std::move(other.m_pending))
+			, m_nodes(std::move(other.m_nodes))
+			, m_by_low(std::move(other.m_by_low))
+			, m_by_high(std::move(other.m_by_high))
+			, m_root(std::exchange(other.m_root, no_node))
+			, m_next_id(other.m_next_id)
+			, m_num_retired(std::exchange(other.m_num_retired, 0))
+			, m_emission_depth(0)
+			, m_stale(other.m_stale)
+			, m_signal_proxy(std::move(other.m_signal_proxy))
+		{
+			rebind_signal_proxy(this);
+		}
+
+		routed_signal& operator=(routed_signal&& other) noexcept {
+			if (this != std::addressof(other)) {
+				rebind_signal_proxy(nullptr);
+				m_extract = std::move(other.m_extract);
+				m_subscriptions = std::move(other.m_subscriptions);
+				m_pending = std::move(other.m_pending);
+				m_nodes = std::move(other.m_nodes);
+				m_by_low = std::move(other.m_by_low);
+				m_by_high = std::move(other.m_by_high);
+				m_root = std::exchange(other.m_root, no_node);
+				m_next_id = other.m_next_id;
+				m_num_retired = std::exchange(other.m_num_retired, 0);
+				m_stale = other.m_stale;
+				m_signal_proxy = std::move(other.m_signal_proxy);
+				rebind_signal_proxy(this);
+			}
+			return *this;
+		}
+
+		~routed_signal() {
+			rebind_signal_proxy(nullptr);
+		}
+
+		// connects a callable that is invoked for the keys in range
+		template <class F, std::enable_if_t<std::is_invocable_r_v<Ret, std::decay_t<F>&, Args...>, int> = 0>
+		connection connect(F&& slot, const key_range<Key>& range) {
+			const auto& proxy = signal_proxy();
+			auto entry = std::make_unique<subscription>(m_next_id, range);
+			detail::emplace_slot(entry->slot, std::forward<F>(slot));
+			if (m_emission_depth) {
+				m_pending.push_back(std::move(entry));
+			}
+			else {
+				m_subscriptions.push_back(std::move(entry));
+				m_stale = true;
+			}
+			return connection(m_next_id++, proxy);
+		}
+
+		// connects a non-const member function for the keys in range
+		template <class T, class R, std::enable_if_t<std::is_void_v<Ret> || std::is_same_v<R, Ret>, int> = 0>
+		void connect(T* obj, R(T::*func)(Args...), const key_range<Key>& range) {
+			receiver::connect_member<Ret, Args...>(obj, func, [this, &range](auto&& slot) {
+				return connect(std::move(slot), range);
+			});
+		}
+
+		// connects a const member function for the keys in range
+		template <class T, class R, std::enable_if_t<std::is_void_v<Ret> || std::is_same_v<R, Ret>, int> = 0>
+		void connect(T* obj, R(T::*func)(Args...) const, const key_range<Key>& range) {
+			receiver::connect_member<Ret, Args...>(obj, func, [this, &range](auto&& slot) {
+				return connect(std::move(slot), range);
+			});
+		}
+
+		// invokes the slots whose range holds the key of args
+		void operator()(Args... args) noexcept(nothrow_emission) {
+			emit(args...);
+		}
+
+		// invokes the slots whose range holds the key of args, an emission 
+		// that rebuilds the index allocates. Nested emissions keep the index
+		// of the outermost one, whose slots all outlive it.
+		void emit(Args... args) noexcept(nothrow_emission) {
+			if (m_subscriptions.empty())
+				return;
+			emission_scope scope(*this);
+			if (m_stale && m_emission_depth == 1)
+				rebuild();
+
+			const Key key = m_extract(args...);
+			small_vector<subscription*, 16> matches;
+			find(key, matches);
+			std::sort(matches.begin(), matches.end(), [](const subscription* lhs, const subscription* rhs) {
+				return lhs->id < rhs->id;
+			});
+
+			exception_handler handler;
+			for (const subscription* match : matches) {
+				const auto& slot = match->slot.slot();
+				if (slot)
+					handler.invoke([&] { slot(args...); });
+			}
+			handler.finish();
+		}
+
+		// checks if *this contains any slot
+		bool empty() const noexcept {
+			return size() == 0;
+		}
+
+		// returns the number of slots attached to *this
+		size_t size() const noexcept {
+			return m_subscriptions.size() - m_num_retired + m_pending.size();
+		}
+
+		// disconnects all slots
+		void clear() noexcept {
+			if (m_emission_depth) {
+				for (auto& entry : m_subscriptions) {
+					if (entry->slot.slot()) {
+						entry->slot.disable();
+						++m_num_retired;
+					}
+				}
+			}
+			else {
+				m_subscriptions.clear();
+			}
+			m_pending.clear();
+			m_stale = true;
+		}
+
+		void swap(routed_signal& other) noexcept {
+			if (this != std::addressof(other)) {
+				routed_signal temp(std::move(other));
+				other = std::move(*this);
+				*this = std::move(temp);
+			}
+		}
+
+	private:
+
+		routed_signal(const routed_signal&) = delete;
+		routed_signal& operator=(const routed_signal&) = delete;
+
+		// the proxy is only allocated once a slot is connected
+		const std::shared_ptr<detail::signal_proxy_base>& signal_proxy() {
+			if (!m_signal_proxy)
+				m_signal_proxy = std::make_shared<signal_proxy_type>(this, signal_access());
+			return m_signal_proxy;
+		}
+
+		void rebind_signal_proxy(routed_signal* signal) noexcept {
+			if (m_signal_proxy)
+				static_cast<signal_proxy_type*>(m_signal_proxy.get())->rebind(signal);
+		}
+
+		static const detail::signal_access& signal_access() noexcept {
+			static constexpr detail::signal_access access = {
+				[](const void* signal, uint64_t slot_id) { return static_cast<const routed_signal*>(signal)->connected(slot_id); },
+				[](void* signal, uint64_t slot_id) -> detail::deferred_hook { static_cast<routed_signal*>(signal)->disconnect(slot_id); return nullptr; }
+			};
+			return access;
+		}
+
+		template <class Subscriptions>
+		static auto find_subscription(Subscriptions& subscriptions, uint64_t slot_id) noexcept {
+			auto it = detail::lower_bound(subscriptions.begin(), subscriptions.end(), slot_id,
+				[](const std::unique_ptr<subscription>& entry) { return entry->id; });
+			return it != subscriptions.end() && (*it)->id == slot_id ? it : subscriptions.end();
+		}
+
+		bool connected(uint64_t slot_id) const noexcept {
+			auto it = find_subscription(m_subscriptions, slot_id);
+			if (it != m_subscriptions.end())
+				return bool((*it)->slot.slot());
+			return find_subscription(m_pending, slot_id) != m_pending.end();
+		}
+
+		// the slot might be running, its destruction waits until the 
+		// outermost emission ends
+		void disconnect(uint64_t slot_id) noexcept {
+			auto pending = find_subscription(m_pending, slot_id);
+			if (pending != m_pending.end()) {
+				m_pending.erase(pending);
+				return;
+			}
+			auto it = find_subscription(m_subscriptions, slot_id);
+			if (it == m_subscriptions.end() || !(*it)->slot.slot())
+				return;
+			if (m_emission_depth) {
+				(*it)->slot.disable();
+				++m_num_retired;
+			}
+			else {
+				m_subscriptions.erase(it);
+			}
+			m_stale = true;
+		}
+
+		// runs once the outermost emission has ended: drops the disabled
+		// subscriptions and moves the pending ones over, after which the
+		// interval index is rebuilt by the next emission. A subscription
+		// that cannot be moved for a lack of memory stays pending.
+		void settle() noexcept {
+			if (m_num_retired) {
+				m_subscriptions.erase(std::remove_if(m_subscriptions.begin(), m_subscriptions.end(),
+					[](const std::unique_ptr<subscription>& entry) { return !entry->slot.slot(); }), m_subscriptions.end());
+				m_num_retired = 0;
+			}
+			size_t num_settled = 0;
+			try {
+				for (; num_settled < m_pending.size(); ++num_settled)
+					m_subscriptions.push_back(std::move(m_pending[num_settled]));
+			}
+			catch (...) {}
+			if (num_settled)
+				m_stale = true;
+			m_pending.erase(m_pending.begin(), m_pending.begin() + num_settled);
+		}
+
+		// indexes the ranges of the connected slots, empty ranges are left out
+		void rebuild() {
+			std::vector<subscription*> entries;
+			entries.reserve(m_subscriptions.size());
+			for (const auto& entry : m_subscriptions) {
+				if (entry->slot.slot() && !(entry->range.high < entry->range.low))
+					entries.push_back(entry.get());
+			}
+			m_nodes.clear();
+			m_by_low.clear();
+			m_by_high.clear();
+			m_nodes.reserve(entries.size());
+			m_by_low.reserve(entries.size());
+			m_by_high.reserve(entries.size());
+			m_root = build(entries.data(), entries.data() + entries.size());
+			m_stale = false;
+		}
+
+		// builds the subtree of the ranges in [first, last), which it 
+		// reorders. The center is the median of the low ends, so neither
+		// side holds more than half of the ranges, and the range that has 
+		// the median low end always stays at the node.
+		size_t build(subscription** first, subscription** last) {
+			if (first == last)
+				return no_node;
+			subscription** middle = first + (last - first) / 2;
+			std::nth_element(first, middle, last, [](const subscription* lhs, const subscription* rhs) {
+				return lhs->range.low < rhs->range.low;
+			});
+			const Key center = (*middle)->range.low;
+			subscription** overlapping = std::partition(first, last, 
+				[&](const subscription* entry) { return entry->range.high < center; });
+			subscription** right = std::partition(overlapping, last, 
+				[&](const subscription* entry) { return !(center < entry->range.low); });
+
+			const size_t index = m_nodes.size();
+			const size_t begin = m_by_low.size();
+			m_nodes.push_back({ center, begin, begin + static_cast<size_t>(right - overlapping), no_node, no_node });
+			m_by_low.insert(m_by_low.end(), overlapping, right);
+			std::sort(m_by_low.begin() + begin, m_by_low.end(), [](const subscription* lhs, const subscription* rhs) {
+				return lhs->range.low < rhs->range.low;
+			});
+			m_by_high.insert(m_by_high.end(), overlapping, right);
+			std::sort(m_by_high.begin() + begin, m_by_high.end(), [](const subscription* lhs, const subscription* rhs) {
+				return rhs->range.high < lhs->range.high;
+			});
+
+			const size_t left_node = build(first, overlapping);
+			const size_t right_node = build(right, last);
+			m_nodes[index].left = left_node;
+			m_nodes[index].right = right_node;
+			return index;
+		}
+
+		// collects the ranges that hold key, walking from the root towards
+		// key and taking the ranges of each node until one does not hold it
+		void find(const Key& key, small_vector<subscription*, 16>& matches) const {
+			if constexpr (std::is_floating_point_v<Key>) {
+				if (key != key)
+					return;
+			}
+			for (size_t n = m_root; n != no_node;) {
+				const index_node& current = m_nodes[n];
+				if (key < current.center) {
+					for (size_t i = current.first; i < current.last && !(key < m_by_low[i]->range.low); ++i)
+						matches.emplace_back(m_by_low[i]);
+					n = current.left;
+				}
+				else if (current.center < key) {
+					for (size_t i = current.first; i < current.last && !(m_by_high[i]->range.high < key); ++i)
+						matches.emplace_back(m_by_high[i]);
+					n = current.right;
+				}
+				else {
+					for (size_t i = current.first; i < current.last; ++i)
+						matches.emplace_back(m_by_low[i]);
+					return;
+				}
+			}
+		}
+
+		key_extractor m_extract;
+		std::vector<std::unique_ptr<subscription>> m_subscriptions;
+		// slots connected during an emission, they join m_subscriptions 
+		// once the outermost emission ends
+		std::vector<std::unique_ptr<subscription>> m_pending;
+		std::vector<index_node> m_nodes;
+		std::vector<subscription*> m_by_low;
+		std::vector<subscription*> m_by_high;
+		size_t m_root;
+		uint64_t m_next_id;
+		size_t m_num_retired;
+		uint32_t m_emission_depth;
+		bool m_stale;
+		std::shared_ptr<detail::signal_proxy_base> m_signal_proxy;
+	};
+
+}
@@ -0,0 +1,212 @@
+// The topic hub of proto, which routes emissions by dotted topic names.
+// It lives apart from proto.hpp so that only its users pay for the 
+// containers and strings it needs.
+// Licensed under the MIT License https://opensource.org/licenses/MIT
+
+#pragma once
+
+#include "proto.hpp"
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace proto {
+
+	template <class Signature, class ExceptionPolicy = propagate_exceptions>
+	class topic_hub;
+
+	// Routes emissions by dotted topic names, such as "orders.eu.filled", to
+	// the slots connected under matching filters. A filter level of "*" 
+	// matches any single topic level, and a last level of "#" matches the
+	// remaining levels, including none. Filters are compiled into a trie 
+	// whose nodes each hold a signal with the slots of their filter, so 
+	// slots are connected and disconnected like the slots of any signal.
+	// Each emitted topic is resolved once into the list of matching filters
+	// that have slots, and the list is cached until a filter gains its first
+	// slot or loses its last one. Slots are invoked filter by filter. Under
+	// isolate_exceptions each filter whose slots threw contributes its own
+	// proto::emission_error to the one the emission raises.
+	template <class Ret, class... Args, bool Nothrow, class ExceptionPolicy>
+	class topic_hub<Ret(Args...) noexcept(Nothrow), ExceptionPolicy> final {
+		using signal_type = basic_signal<Ret(Args...) noexcept(Nothrow), single_threaded, ExceptionPolicy>;
+
+		static constexpr bool nothrow_emission = Nothrow || ExceptionPolicy::nothrow;
+
+		using exception_handler = std::conditional_t<nothrow_emission,
+			propagate_exceptions::handler, typename ExceptionPolicy::handler>;
+
+		// the signal of a filter is created along with its first slot
+		struct node {
+			std::map<std::string, std::unique_ptr<node>, std::less<>> children;
+			std::unique_ptr<node> any_level;
+			std::unique_ptr<node> any_levels;
+			std::unique_ptr<signal_type> slots;
+		};
+
+		// the filters with slots that match a topic
+		struct route {
+			std::string topic;
+			std::vector<signal_type*> signals;
+		};
+
+		// nodes are never removed, which keeps the signals of a route alive
+		// for as long as the hub, and routes are shared with the emissions
+		// that use them so the cache can be invalidated by their slots
+		struct trie {
+			node root;
+			std::unordered_map<std::string_view, std::shared_ptr<const route>> routes;
+			size_t cache_capacity;
+		};
+	public:
+
+		using threading_policy = single_threaded;
+		using exception_policy = ExceptionPolicy;
+
+		// at most cache_capacity topics are cached, the cache is emptied
+		// once it is full
+		explicit topic_hub(size_t cache_capacity = 1024) noexcept
+			: m_cache_capacity(cache_capacity ? cache_capacity : 1) {}
+
+		topic_hub(topic_hub&&) noexcept = default;
+		topic_hub& operator=(topic_hub&&) noexcept = default;
+
+		topic_hub(const topic_hub&) = delete;
+		topic_hub& operator=(const topic_hub&) = delete;
+
+		// connects a slot under filter, params are those of 
+		// basic_signal::connect. Throws std::invalid_argument if a level of
+		// filter mixes a wildcard with other characters, or if "#" is not
+		// its last level.
+		template <class... Params>
+		decltype(auto) connect(std::string_view filter, Params&&... params) {
+			return slots_of(filter).connect(std::forward<Params>(params)...);
+		}
+
+		// invokes the slots of every filter that matches topic, resolving a
+		// topic that is not cached allocates
+		void emit(std::string_view topic, Args... args) noexcept(nothrow_emission) {
+			if (!m_trie)
+				return;
+			std::shared_ptr<const route> targets = resolve(topic);
+			exception_handler handler;
+			for (signal_type* signal : targets->signals)
+				handler.invoke([&] { signal->emit(args...); });
+			handler.finish();
+		}
+
+		// disconnects all slots
+		void clear() noexcept {
+			if (m_trie)
+				clear(m_trie->root);
+		}
+
+		void swap(topic_hub& other) noexcept {
+			using std::swap;
+			swap(m_trie, other.m_trie);
+			swap(m_cache_capacity, other.m_cache_capacity);
+		}
+
+	private:
+		signal_type& slots_of(std::string_view filter) {
+			if (!m_trie) {
+				m_trie = std::make_unique<trie>();
+				m_trie->cache_capacity = m_cache_capacity;
+			}
+			node* current = &m_trie->root;
+			for (bool last = false; !last;) {
+				const size_t dot = filter.find('.');
+				const std::string_view level = filter.substr(0, dot);
+				last = dot == std::string_view::npos;
+				filter.remove_prefix(last ? filter.size() : dot + 1);
+				if (level == "#") {
+					if (!last)
+						throw std::invalid_argument("proto::topic_hub: # must be the last level of a filter");
+					current = &child(current->any_levels);
+				}
+				else if (level == "*") {
+					current = &child(current->any_level);
+				}
+				else if (level.find_first_of("*#") != std::string_view::npos) {
+					throw std::invalid_argument("proto::topic_hub: wildcards must make up a whole filter level");
+				}
+				else {
+					auto it = current->children.find(level);
+					if (it == current->children.end())
+						it = current->children.emplace(std::string(level), std::make_unique<node>()).first;
+					current = it->second.get();
+				}
+			}
+			if (!current->slots) {
+				auto slots = std::make_unique<signal_type>();
+				trie* routes = m_trie.get();
+				slots->on_observed([routes] { routes->routes.clear(); });
+				slots->on_unobserved([routes] { routes->routes.clear(); });
+				current->slots = std::move(slots);
+			}
+			return *current->slots;
+		}
+
+		static node& child(std::unique_ptr<node>& next) {
+			if (!next)
+				next = std::make_unique<node>();
+			return *next;
+		}
+
+		std::shared_ptr<const route> resolve(std::string_view topic) {
+			auto it = m_trie->routes.find(topic);
+			if (it != m_trie->routes.end())
+				return it->second;
+			auto resolved = std::make_shared<route>();
+			resolved->topic = topic;
+			match(m_trie->root, topic, false, resolved->signals);
+			if (m_trie->routes.size() >= m_trie->cache_capacity)
+				m_trie->routes.clear();
+			m_trie->routes.emplace(resolved->topic, resolved);
+			return resolved;
+		}
+
+		// collects the signals with slots under the filters of current that
+		// match the levels of topic, of which there are none once at_end
+		static void match(const node& current, std::string_view topic, bool at_end, std::vector<signal_type*>& signals) {
+			if (current.any_levels)
+				collect(*current.any_levels, signals);
+			if (at_end) {
+				collect(current, signals);
+				return;
+			}
+			const size_t dot = topic.find('.');
+			const std::string_view level = topic.substr(0, dot);
+			const bool last = dot == std::string_view::npos;
+			const std::string_view rest = last ? std::string_view() : topic.substr(dot + 1);
+			auto it = current.children.find(level);
+			if (it != current.children.end())
+				match(*it->second, rest, last, signals);
+			if (current.any_level)
+				match(*current.any_level, rest, last, signals);
+		}
+
+		static void collect(const node& current, std::vector<signal_type*>& signals) {
+			if (current.slots && !current.slots->empty())
+				signals.push_back(current.slots.get());
+		}
+
+		static void clear(node& current) noexcept {
+			if (current.slots)
+				current.slots->clear();
+			for (auto& [_, next] : current.children)
+				clear(*next);
+			if (current.any_level)
+				clear(*current.any_level);
+			if (current.any_levels)
+				clear(*current.any_levels);
+		}
+
+		std::unique_ptr<trie> m_trie;
+		size_t m_cache_capacity;
+	};
+
+}
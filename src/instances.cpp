@@ -0,0 +1,4 @@
+#include <proto/proto.hpp>
+
+// instantiates the signals declared extern under PROTO_EXTERN_COMMON_SIGNALS
+PROTO_COMMON_SIGNALS(PROTO_INSTANTIATE_SIGNAL);
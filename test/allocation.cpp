@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <proto/proto.hpp>
+#include <array>
+#include <new>
+#include <vector>
+#include "allocation_counter.hpp"
+
+// Allocation budgets of the hot paths. Counts are taken around single
+// operations, assertions only run once counting has ended.
+
+namespace {
+
+	int sum = 0;
+
+	int triple(int x) noexcept {
+		return 3 * x;
+	}
+
+}
+
+template <class Signal>
+class SignalAllocationTests : public ::testing::Test {};
+
+using SingleThreadedSignals = ::testing::Types<
+	proto::signal<int(int)>,
+	proto::small_signal<int(int), 4>,
+	proto::paged_signal<int(int), 16>,
+	proto::fixed_signal<int(int), 64>>;
+
+TYPED_TEST_SUITE(SignalAllocationTests, SingleThreadedSignals);
+
+TYPED_TEST(SignalAllocationTests, EmitTests) {
+	TypeParam signal;
+	int offset = 1;
+	for (int i = 0; i < 32; ++i)
+		signal.connect([offset](int x) { sum += x; return x + offset; });
+	signal.connect(triple);
+
+	std::vector<int> values;
+	values.reserve(64);
+	std::array<int, 64> buffer;
+
+	allocation_counter counter;
+	signal.emit(1);
+	const size_t emit_allocations = counter.count();
+	counter.reset();
+	signal.collect(std::back_inserter(values), 1);
+	const size_t collect_allocations = counter.count();
+	counter.reset();
+	const size_t num_values = signal.collect_into(buffer.begin(), buffer.end(), 1);
+	const size_t collect_into_allocations = counter.count();
+
+	ASSERT_EQ(emit_allocations, 0);
+	ASSERT_EQ(collect_allocations, 0);
+	ASSERT_EQ(collect_into_allocations, 0);
+	ASSERT_EQ(values.size(), 33);
+	ASSERT_EQ(num_values, 33);
+}
+
+TYPED_TEST(SignalAllocationTests, ConnectTests) {
+	// once reserved, a small lambda is stored without an allocation of its
+	// own, paged signals allocate a page every 16 slots
+	TypeParam signal;
+	signal.reserve(64);
+	std::array<proto::connection, 64> conns;
+	std::array<size_t, 64> allocations;
+	for (size_t i = 0; i < conns.size(); ++i) {
+		allocation_counter counter;
+		conns[i] = signal.connect([i](int x) { return x + int(i); });
+		allocations[i] = counter.count();
+	}
+
+	size_t total = 0;
+	for (size_t count : allocations) {
+		ASSERT_LE(count, 1);
+		total += count;
+	}
+	ASSERT_LE(total, 4);
+	ASSERT_EQ(signal.size(), 64);
+}
+
+TYPED_TEST(SignalAllocationTests, CloseTests) {
+	TypeParam signal;
+	std::array<proto::connection, 32> conns;
+	for (size_t i = 0; i < conns.size(); ++i)
+		conns[i] = signal.connect([i](int x) { return x + int(i); });
+	// closes other slots mid emission, which leaves tombstones behind
+	proto::connection closer = signal.connect([&](int x) {
+		for (size_t i = 0; i < conns.size(); i += 2)
+			conns[i].close();
+		return x;
+	});
+
+	allocation_counter counter;
+	signal.emit(1);
+	for (size_t i = 1; i < conns.size(); i += 2)
+		conns[i].close();
+	closer.close();
+	const size_t close_allocations = counter.count();
+
+	ASSERT_EQ(close_allocations, 0);
+	ASSERT_TRUE(signal.empty());
+}
+
+TEST(AllocationTests, GrowthTests) {
+	// contiguous signals grow their hot and cold slot arrays together, by
+	// doubling their capacity
+	proto::signal<void(int)> signal;
+	size_t total = 0;
+	size_t max = 0;
+	for (int i = 0; i < 1024; ++i) {
+		allocation_counter counter;
+		signal.connect([i](int x) { sum += x + i; });
+		total += counter.count();
+		max = counter.count() > max ? counter.count() : max;
+	}
+	ASSERT_LE(max, 2);
+	ASSERT_LE(total, 2 * 9);
+}
+
+TEST(AllocationTests, LargeCallableTests) {
+	// callables that do not fit into the slot storage take one allocation
+	proto::signal<int(int)> signal;
+	signal.reserve(4);
+	std::array<int, 16> table = {};
+
+	allocation_counter counter;
+	proto::connection conn = signal.connect([table](int x) { return table[0] + x; });
+	const size_t connect_allocations = counter.count();
+	counter.reset();
+	conn.close();
+	const size_t close_allocations = counter.count();
+
+	ASSERT_EQ(connect_allocations, 1);
+	ASSERT_EQ(close_allocations, 0);
+}
+
+TEST(AllocationTests, CounterTests) {
+	// the replicas and cells of the concurrent stores are over-aligned, so
+	// the counter has to see every form of operator new
+	struct alignas(64) line { int value; };
+
+	// the pointers escape, so that the allocations are not elided
+	static line* volatile lines;
+	static int* volatile ints;
+	allocation_counter counter;
+	lines = new line();
+	delete lines;
+	lines = new line[2]();
+	delete[] lines;
+	ints = new (std::nothrow) int(0);
+	delete ints;
+	lines = new (std::nothrow) line[2]();
+	delete[] lines;
+	const size_t allocations = counter.count();
+	bool failed = false;
+	{
+		allocation_guard guard;
+		lines = new (std::nothrow) line();
+		failed = lines == nullptr;
+	}
+
+	ASSERT_EQ(allocations, 4);
+	ASSERT_TRUE(failed);
+}
+
+template <class ThreadingPolicy>
+class ConcurrentAllocationTests : public ::testing::Test {};
+
+using ConcurrentPolicies = ::testing::Types<
+	proto::spin_locked,
+	proto::shared_locked,
+	proto::rcu_snapshots,
+	proto::numa_replicated<proto::rcu_snapshots>>;
+
+TYPED_TEST_SUITE(ConcurrentAllocationTests, ConcurrentPolicies);
+
+TYPED_TEST(ConcurrentAllocationTests, EmitTests) {
+	// connections publish new snapshots and allocate, emissions do not
+	proto::basic_signal<int(int), TypeParam> signal;
+	for (int i = 0; i < 8; ++i)
+		signal.connect([i](int x) { return x + i; });
+	std::vector<int> values;
+	values.reserve(8);
+
+	allocation_counter counter;
+	signal.emit(1);
+	signal.collect(std::back_inserter(values), 1);
+	const size_t allocations = counter.count();
+
+	ASSERT_EQ(allocations, 0);
+	ASSERT_EQ(values.size(), 8);
+}
@@ -0,0 +1,142 @@
+#include "allocation_counter.hpp"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+	thread_local size_t num_allocations = 0;
+	thread_local bool fail_allocations = false;
+
+	// every replaced operator new allocates through these two, so that
+	// array, nothrow and over-aligned allocations are counted and fail
+	// like plain ones
+	void* allocate(std::size_t size, std::size_t alignment) noexcept {
+		if (fail_allocations)
+			return nullptr;
+		size = size ? size : 1;
+		void* ptr = nullptr;
+		if (alignment <= alignof(std::max_align_t)) {
+			ptr = std::malloc(size);
+		}
+		else {
+#if defined(_WIN32)
+			ptr = _aligned_malloc(size, alignment);
+#else
+			// aligned_alloc takes a multiple of the alignment
+			ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+		}
+		if (ptr)
+			++num_allocations;
+		return ptr;
+	}
+
+	void deallocate(void* ptr, std::size_t alignment) noexcept {
+#if defined(_WIN32)
+		if (alignment > alignof(std::max_align_t)) {
+			_aligned_free(ptr);
+			return;
+		}
+#else
+		(void)alignment;
+#endif
+		std::free(ptr);
+	}
+
+	void* allocate_or_throw(std::size_t size, std::size_t alignment) {
+		if (void* ptr = allocate(size, alignment))
+			return ptr;
+		throw std::bad_alloc();
+	}
+
+	constexpr std::size_t default_alignment = alignof(std::max_align_t);
+
+}
+
+size_t allocations::count() noexcept {
+	return num_allocations;
+}
+
+void allocations::fail(bool enabled) noexcept {
+	fail_allocations = enabled;
+}
+
+void* operator new(std::size_t size) {
+	return allocate_or_throw(size, default_alignment);
+}
+
+void* operator new[](std::size_t size) {
+	return allocate_or_throw(size, default_alignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+	return allocate(size, default_alignment);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+	return allocate(size, default_alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+	return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+	return allocate_or_throw(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept {
+	deallocate(ptr, default_alignment);
+}
+
+void operator delete[](void* ptr) noexcept {
+	deallocate(ptr, default_alignment);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	deallocate(ptr, default_alignment);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+	deallocate(ptr, default_alignment);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+	deallocate(ptr, default_alignment);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+	deallocate(ptr, default_alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept {
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept {
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept {
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept {
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
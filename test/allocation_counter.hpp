@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+
+// Test executables that link allocation_counter.cpp replace every form of
+// the global operator new and delete, including the array, nothrow and 
+// over-aligned ones, with versions that count the allocations of
+// each thread and can make them fail.
+
+namespace allocations {
+
+	// the number of allocations the calling thread has made
+	size_t count() noexcept;
+
+	// while enabled, every allocation of the calling thread throws 
+	// std::bad_alloc
+	void fail(bool enabled) noexcept;
+
+}
+
+// counts the allocations of the calling thread during its lifetime
+class allocation_counter {
+public:
+	allocation_counter() noexcept
+		: m_start(allocations::count()) {}
+
+	allocation_counter(const allocation_counter&) = delete;
+	allocation_counter& operator=(const allocation_counter&) = delete;
+
+	size_t count() const noexcept {
+		return allocations::count() - m_start;
+	}
+
+	void reset() noexcept {
+		m_start = allocations::count();
+	}
+
+private:
+	size_t m_start;
+};
+
+// makes every allocation of the calling thread fail during its lifetime
+class allocation_guard {
+public:
+	allocation_guard() noexcept {
+		allocations::fail(true);
+	}
+
+	allocation_guard(const allocation_guard&) = delete;
+	allocation_guard& operator=(const allocation_guard&) = delete;
+
+	~allocation_guard() {
+		allocations::fail(false);
+	}
+};
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <proto/proto.hpp>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace {
+
+	int Triple(int x) { return 3 * x; }
+
+	struct DummyReceiver : proto::receiver {
+		int function0(int x) { return x + offset; }
+		int function1(int x) const { return x - offset; }
+
+		int offset = 1;
+	};
+
+}
+
+TEST(DelegateTests, ConnectionTests) {
+	proto::delegate<int(int)> delegate;
+	ASSERT_TRUE(delegate.empty());
+	ASSERT_THROW(delegate(1), std::bad_function_call);
+
+	proto::connection conn0 = delegate.connect(Triple);
+	ASSERT_TRUE(conn0);
+	ASSERT_FALSE(delegate.empty());
+	ASSERT_EQ(delegate(2), 6);
+
+	// connecting again replaces the target
+	int offset = 5;
+	proto::connection conn1 = delegate.connect([offset](int x) { return x + offset; });
+	ASSERT_FALSE(conn0);
+	ASSERT_TRUE(conn1);
+	ASSERT_EQ(delegate(2), 7);
+
+	// closing a replaced connection leaves the current target alone
+	conn0.close();
+	ASSERT_EQ(delegate(2), 7);
+
+	conn1.close();
+	ASSERT_TRUE(delegate.empty());
+	ASSERT_THROW(delegate(1), std::bad_function_call);
+
+	// large callables are stored on the heap
+	std::array<int, 16> values = { 1, 2, 3 };
+	proto::connection conn2 = delegate.connect([values](int x) { return values[2] * x; });
+	ASSERT_EQ(delegate(2), 6);
+	delegate.clear();
+	ASSERT_FALSE(conn2);
+}
+
+TEST(DelegateTests, MoveTests) {
+	proto::delegate<std::string()> delegate;
+	std::string name(64, 'x');
+	proto::connection conn = delegate.connect([name]() { return name; });
+
+	proto::delegate<std::string()> moved(std::move(delegate));
+	ASSERT_TRUE(delegate.empty());
+	ASSERT_EQ(moved(), name);
+	ASSERT_TRUE(conn);
+
+	proto::delegate<std::string()> swapped;
+	swapped.connect([]() { return std::string("y"); });
+	swapped.swap(moved);
+	ASSERT_EQ(swapped(), name);
+	ASSERT_EQ(moved(), "y");
+
+	conn.close();
+	ASSERT_TRUE(swapped.empty());
+	ASSERT_FALSE(moved.empty());
+}
+
+TEST(DelegateTests, ReentrancyTests) {
+	proto::delegate<void()> delegate;
+	std::vector<int> invoked;
+	proto::connection conn;
+	std::string name(64, 'x');
+
+	// a target that disconnects itself keeps its captures until it returns
+	conn = delegate.connect([&, name]() {
+		conn.close();
+		invoked.push_back(static_cast<int>(name.size()));
+	});
+	delegate();
+	ASSERT_EQ(invoked, std::vector<int>({ 64 }));
+	ASSERT_TRUE(delegate.empty());
+
+	// a replacement is first invoked once the running target returns
+	delegate.connect([&, name]() {
+		delegate.connect([&]() { invoked.push_back(1); });
+		invoked.push_back(static_cast<int>(name.size()));
+	});
+	invoked.clear();
+	delegate();
+	delegate();
+	ASSERT_EQ(invoked, std::vector<int>({ 64, 1 }));
+
+	// until then the delegate reports no target, and a nested invocation
+	// throws as it would for an empty delegate
+	bool nested_empty = false;
+	bool nested_threw = false;
+	delegate.connect([&]() {
+		delegate.connect([&]() { invoked.push_back(2); });
+		nested_empty = delegate.empty() && !delegate;
+		try {
+			delegate();
+		}
+		catch (const std::bad_function_call&) {
+			nested_threw = true;
+		}
+	});
+	invoked.clear();
+	delegate();
+	ASSERT_TRUE(nested_empty);
+	ASSERT_TRUE(nested_threw);
+	ASSERT_TRUE(delegate);
+	delegate();
+	ASSERT_EQ(invoked, std::vector<int>({ 2 }));
+}
+
+TEST(DelegateTests, DiscardedResultTests) {
+	// void delegates accept targets that return a value and drop it
+	int sum = 0;
+	proto::delegate<void(int)> delegate;
+	delegate.connect([&sum](int x) { sum += x; return sum; });
+	delegate(2);
+	delegate.connect(Triple);
+	delegate(2);
+	delegate.connect([](int x) { return x; });
+	delegate(2);
+	ASSERT_EQ(sum, 2);
+
+	DummyReceiver receiver;
+	delegate.connect(&receiver, &DummyReceiver::function0);
+	delegate(2);
+	delegate.connect(&receiver, &DummyReceiver::function1);
+	delegate(2);
+	ASSERT_EQ(receiver.num_connections(), 1);
+}
+
+TEST(DelegateTests, ReceiverTests) {
+	proto::delegate<int(int)> delegate;
+	{
+		DummyReceiver receiver;
+		delegate.connect(&receiver, &DummyReceiver::function0);
+		ASSERT_EQ(receiver.num_connections(), 1);
+		ASSERT_EQ(delegate(1), 2);
+
+		delegate.connect(&receiver, &DummyReceiver::function1);
+		ASSERT_EQ(receiver.num_connections(), 1);
+		ASSERT_EQ(delegate(1), 0);
+	}
+	ASSERT_TRUE(delegate.empty());
+}
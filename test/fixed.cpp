@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <proto/proto.hpp>
+#include <new>
+#include <vector>
+#include "allocation_counter.hpp"
+
+namespace {
+
+	int sum = 0;
+
+	void add(int x) noexcept {
+		sum += x;
+	}
+
+	int triple(int x) noexcept {
+		return 3 * x;
+	}
+
+}
+
+TEST(FixedSignalTests, CapacityTests) {
+	proto::fixed_signal<int(int), 3, 16> signal;
+	int offset = 1;
+	proto::connection conn0 = signal.connect([offset](int x) { return x + offset; });
+	proto::connection conn1 = signal.connect([](int x) { return 2 * x; });
+	proto::connection conn2 = signal.connect([&offset](int x) { return x + 2 * offset; });
+	ASSERT_EQ(signal.size(), 3);
+
+	// a full signal returns an empty connection, which does not count as
+	// an observer
+	int num_observed = 0;
+	signal.on_unobserved([&]() { --num_observed; });
+	proto::connection conn3 = signal.connect([](int x) { return x; });
+	ASSERT_FALSE(conn3);
+	ASSERT_EQ(signal.size(), 3);
+
+	std::vector<int> values;
+	signal.collect(std::back_inserter(values), 1);
+	ASSERT_EQ(values, std::vector<int>({ 2, 2, 3 }));
+
+	conn1.close();
+	ASSERT_FALSE(conn1);
+	ASSERT_TRUE(conn0);
+	ASSERT_TRUE(conn2);
+	conn3 = signal.connect([](int x) { return x; });
+	ASSERT_TRUE(conn3);
+
+	values.clear();
+	signal.collect(std::back_inserter(values), 1);
+	ASSERT_EQ(values, std::vector<int>({ 2, 3, 1 }));
+
+	signal.clear();
+	ASSERT_TRUE(signal.empty());
+	ASSERT_FALSE(conn0);
+	ASSERT_EQ(num_observed, -1);
+}
+
+TEST(FixedSignalTests, ReentrancyTests) {
+	proto::fixed_signal<void(), 4> signal;
+	std::vector<int> invoked;
+	proto::connection conn0;
+	proto::connection conn1;
+	conn0 = signal.connect([&]() { invoked.push_back(0); conn1.close(); conn0.close(); });
+	conn1 = signal.connect([&]() { invoked.push_back(1); });
+	signal.connect([&]() { invoked.push_back(2); signal.connect([&]() { invoked.push_back(3); }); });
+
+	signal();
+	ASSERT_EQ(invoked, std::vector<int>({ 0, 2 }));
+	ASSERT_EQ(signal.size(), 2);
+
+	invoked.clear();
+	signal();
+	ASSERT_EQ(invoked, std::vector<int>({ 2, 3 }));
+	ASSERT_EQ(signal.size(), 3);
+}
+
+TEST(FixedSignalTests, MoveTests) {
+	// callables are relocated along with the signal
+	proto::fixed_signal<void(), 2> signal;
+	std::vector<int> invoked;
+	int id = 7;
+	proto::connection conn = signal.connect([&invoked, id]() { invoked.push_back(id); });
+
+	proto::fixed_signal<void(), 2> moved(std::move(signal));
+	moved();
+	ASSERT_EQ(invoked, std::vector<int>({ 7 }));
+	ASSERT_TRUE(conn);
+
+	proto::fixed_signal<void(), 2> swapped;
+	swapped.connect([&invoked]() { invoked.push_back(8); });
+	swapped.swap(moved);
+	invoked.clear();
+	swapped();
+	moved();
+	ASSERT_EQ(invoked, std::vector<int>({ 7, 8 }));
+
+	conn.close();
+	ASSERT_TRUE(swapped.empty());
+}
+
+TEST(FixedSignalTests, MaskedEmissionTests) {
+	// masks follow their slots when tombstones are removed and when the
+	// signal moves
+	proto::fixed_signal<void(), 24> signal;
+	std::vector<int> invoked;
+	std::vector<proto::connection> conns;
+	for (int i = 0; i < 20; ++i)
+		conns.push_back(signal.connect([&invoked, i]() { invoked.push_back(i); }, uint64_t(1) << (i % 4)));
+	for (int i = 0; i < 20; i += 8)
+		conns[i].close();
+
+	proto::fixed_signal<void(), 24> moved(std::move(signal));
+	moved.emit_masked(1);
+	ASSERT_EQ(invoked, std::vector<int>({ 4, 12 }));
+
+	invoked.clear();
+	moved.emit_masked(6);
+	ASSERT_EQ(invoked, std::vector<int>({ 1, 2, 5, 6, 9, 10, 13, 14, 17, 18 }));
+}
+
+TEST(FixedSignalTests, AllocationTests) {
+	proto::fixed_signal<int(int), 4, 16> signal;
+	proto::connection conn0;
+	proto::connection conn1;
+	proto::connection conn2;
+	bool new_failed = false;
+	int values[4] = {};
+	size_t num_values = 0;
+	size_t size = 0;
+	{
+		allocation_guard guard;
+		try {
+			::operator delete(::operator new(1));
+		}
+		catch (const std::bad_alloc&) {
+			new_failed = true;
+		}
+
+		int offset = 1;
+		conn0 = signal.connect(triple);
+		conn1 = signal.connect([offset](int x) { add(x); return x + offset; });
+		conn2 = signal.connect([&signal, &conn1](int x) { conn1.close(); return int(signal.size()) + x; });
+		signal.emit(1);
+		num_values = signal.collect_into(values, values + 4, 1);
+		conn0.close();
+		conn0 = signal.connect([](int x) { return -x; });
+		signal(2);
+		size = signal.size();
+		signal.clear();
+	}
+
+	ASSERT_TRUE(new_failed);
+	ASSERT_EQ(num_values, 2);
+	ASSERT_EQ(values[0], 3);
+	ASSERT_EQ(values[1], 3);
+	ASSERT_EQ(size, 2);
+	ASSERT_EQ(sum, 1);
+	ASSERT_TRUE(signal.empty());
+}
+
+TEST(FixedSignalTests, CountedSlotTests) {
+	// counts follow their slots when tombstones are removed and when the
+	// signal moves, which also moves the disconnection of expired slots
+	proto::fixed_signal<void(int), 4> signal;
+	proto::connection conn = signal.connect(add);
+	signal.connect_n(add, 3);
+	signal.connect_once([](int x) { sum += 10 * x; });
+	conn.close();
+
+	sum = 0;
+	signal(1);
+	ASSERT_EQ(sum, 11);
+	ASSERT_EQ(signal.size(), 1);
+
+	proto::fixed_signal<void(int), 4> moved(std::move(signal));
+	moved(1);
+	moved(1);
+	moved(1);
+	ASSERT_EQ(sum, 13);
+	ASSERT_TRUE(moved.empty());
+}
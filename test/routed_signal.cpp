@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <proto/routed_signal.hpp>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+	struct Quote {
+		int symbol;
+		double price;
+	};
+
+	double price_of(const Quote& quote) {
+		return quote.price;
+	}
+
+	struct QuoteReceiver : proto::receiver {
+		void on_quote(const Quote& quote) { total += quote.price; }
+
+		double total = 0;
+	};
+
+}
+
+TEST(RoutedSignalTests, IndexTests) {
+	// the slots an emission invokes are exactly those whose range holds
+	// the key, in the order they were connected
+	std::mt19937 engine(7);
+	std::uniform_int_distribution<int> bound(0, 1000);
+	std::uniform_int_distribution<int> width(0, 60);
+
+	proto::routed_signal<void(int), int> signal([](int key) { return key; });
+	std::vector<proto::key_range<int>> ranges;
+	std::vector<proto::connection> conns;
+	std::vector<size_t> invoked;
+	for (size_t i = 0; i < 500; ++i) {
+		const int low = bound(engine);
+		ranges.push_back({ low, i % 50 == 0 ? low - 1 : low + width(engine) });
+		conns.push_back(signal.connect([&invoked, i](int) { invoked.push_back(i); }, ranges.back()));
+	}
+	for (size_t i = 0; i < conns.size(); i += 3)
+		conns[i].close();
+	ASSERT_EQ(signal.size(), 333);
+
+	for (int key = -5; key <= 1065; ++key) {
+		std::vector<size_t> expected;
+		for (size_t i = 0; i < ranges.size(); ++i) {
+			if (i % 3 != 0 && ranges[i].low <= key && key <= ranges[i].high)
+				expected.push_back(i);
+		}
+		invoked.clear();
+		signal.emit(key);
+		ASSERT_EQ(invoked, expected);
+	}
+}
+
+TEST(RoutedSignalTests, ReceiverTests) {
+	proto::routed_signal<void(const Quote&), double> signal(price_of);
+	{
+		QuoteReceiver receiver;
+		signal.connect(&receiver, &QuoteReceiver::on_quote, { 99.5, 100.5 });
+		ASSERT_EQ(signal.size(), 1);
+
+		signal.emit(Quote{ 1, 100.25 });
+		signal.emit(Quote{ 1, 101.0 });
+		signal.emit(Quote{ 1, 99.5 });
+		ASSERT_EQ(receiver.total, 199.75);
+
+		// NaN is in no range
+		signal.emit(Quote{ 1, std::numeric_limits<double>::quiet_NaN() });
+		ASSERT_EQ(receiver.total, 199.75);
+	}
+	ASSERT_TRUE(signal.empty());
+}
+
+TEST(RoutedSignalTests, ReentrancyTests) {
+	proto::routed_signal<void(int), int> signal([](int key) { return key; });
+	std::vector<int> invoked;
+	proto::connection conn0;
+	proto::connection conn1;
+	conn0 = signal.connect([&](int) { invoked.push_back(0); conn0.close(); conn1.close(); }, { 0, 10 });
+	conn1 = signal.connect([&](int) { invoked.push_back(1); }, { 5, 15 });
+	signal.connect([&](int x) {
+		invoked.push_back(2);
+		signal.connect([&](int) { invoked.push_back(3); }, { 0, 20 });
+		if (x < 10)
+			signal.emit(x + 10);
+	}, { 5, 20 });
+
+	// slots connected during an emission, nested ones included, are first
+	// invoked by the next emission, and no emission invokes closed slots
+	signal.emit(5);
+	ASSERT_EQ(invoked, std::vector<int>({ 0, 2, 2 }));
+	ASSERT_EQ(signal.size(), 3);
+
+	invoked.clear();
+	signal.emit(20);
+	ASSERT_EQ(invoked, std::vector<int>({ 2, 3, 3 }));
+
+	// a slot closed before its first emission is never invoked
+	proto::connection pending;
+	signal.connect([&](int) {
+		pending = signal.connect([&](int) { invoked.push_back(4); }, { 30, 30 });
+		pending.close();
+	}, { 30, 30 });
+	const size_t size = signal.size();
+	invoked.clear();
+	signal.emit(30);
+	signal.emit(30);
+	ASSERT_TRUE(invoked.empty());
+	ASSERT_FALSE(pending);
+	ASSERT_EQ(signal.size(), size);
+
+	signal.clear();
+	ASSERT_TRUE(signal.empty());
+	invoked.clear();
+	signal.emit(5);
+	ASSERT_TRUE(invoked.empty());
+}
+
+TEST(RoutedSignalTests, MoveTests) {
+	proto::routed_signal<void(int&), int> signal([](const int& x) { return x; });
+	proto::connection conn = signal.connect([](int& x) { x += 100; }, { 0, 10 });
+
+	proto::routed_signal<void(int&), int> moved(std::move(signal));
+	int value = 1;
+	moved.emit(value);
+	ASSERT_EQ(value, 101);
+	ASSERT_TRUE(conn);
+
+	proto::routed_signal<void(int&), int> swapped([](const int& x) { return -x; });
+	swapped.connect([](int& x) { x = 0; }, { -200, -100 });
+	swapped.swap(moved);
+	swapped.emit(value = 5);
+	ASSERT_EQ(value, 105);
+	moved.emit(value = 150);
+	ASSERT_EQ(value, 0);
+
+	conn.close();
+	ASSERT_TRUE(swapped.empty());
+}
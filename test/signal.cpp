@@ -1,6 +1,13 @@
 #include <gtest/gtest.h>
 #include <proto/proto.hpp>
 #include <numeric>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <string>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
 
 struct DummyReceiver0 : proto::receiver {
 	void function0(bool x) { ASSERT_TRUE(x); }
@@ -12,6 +19,29 @@ struct DummyReceiver1 : proto::receiver {
 	void function1(bool x) const { ASSERT_FALSE(x); }
 };
 
+struct CountingSlot {
+	static inline int copies = 0;
+	static inline int moves = 0;
+
+	explicit CountingSlot(int& sum) : sum(&sum) {}
+	CountingSlot(const CountingSlot& other) : sum(other.sum) { ++copies; }
+	CountingSlot(CountingSlot&& other) noexcept : sum(other.sum) { ++moves; }
+
+	void operator()(int x) const { *sum += x; }
+
+	int* sum;
+};
+
+// only constructible in place
+struct PinnedSlot {
+	explicit PinnedSlot(std::unique_ptr<int> value) : value(std::move(value)) {}
+	PinnedSlot(const PinnedSlot&) = delete;
+
+	int operator()(int x) const { return *value * x; }
+
+	std::unique_ptr<int> value;
+};
+
 TEST(SignalTests, DefaultConstructorTests) {
 	proto::signal<void()> signal0;
 	proto::signal<void(int)> signal1;
@@ -251,6 +281,562 @@ TEST(SignalTests, SignalOutputCollectionTests) {
 	ASSERT_EQ(std::accumulate(values.begin(), values.end(), 0), 3);
 }
 
+TEST(SignalTests, SignalResultRangeTests) {
+	proto::signal<int(int)> signal;
+	int num_invocations = 0;
+	signal.connect([&](int x) { ++num_invocations; return x; });
+	signal.connect([&](int x) { ++num_invocations; return x * 2; });
+	signal.connect([&](int x) { ++num_invocations; return x * 3; });
+
+	// Slots are only invoked as the range advances
+	auto results = signal.results(2);
+	ASSERT_EQ(num_invocations, 0);
+	auto it = std::find_if(results.begin(), results.end(), [](int x) { return x == 4; });
+	ASSERT_NE(it, results.end());
+	ASSERT_EQ(*it, 4);
+	ASSERT_EQ(num_invocations, 2);
+	++it;
+	ASSERT_EQ(*it, 6);
+	ASSERT_EQ(num_invocations, 3);
+	++it;
+	ASSERT_EQ(it, results.end());
+
+	int sum = 0;
+	for (int value : signal.results(1))
+		sum += value;
+	ASSERT_EQ(sum, 6);
+	ASSERT_EQ(num_invocations, 6);
+
+	proto::signal<int()> empty_signal;
+	auto empty_results = empty_signal.results();
+	ASSERT_EQ(empty_results.begin(), empty_results.end());
+}
+
+TEST(SignalTests, SignalResultRangeReentrancyTests) {
+	proto::signal<int()> signal;
+	proto::connection conn0 = signal.connect([]() { return 0; });
+	proto::connection conn1 = signal.connect([]() { return 1; });
+	proto::connection conn2 = signal.connect([]() { return 2; });
+
+	std::vector<int> values;
+	for (int value : signal.results()) {
+		values.push_back(value);
+		if (value == 0) {
+			// Disconnected slots are skipped and new slots wait for the next traversal
+			conn1.close();
+			signal.connect([]() { return 3; });
+		}
+	}
+	ASSERT_EQ(values, std::vector<int>({ 0, 2 }));
+
+	// The range follows its signal when moved
+	auto results = signal.results();
+	auto it = results.begin();
+	ASSERT_EQ(*it, 0);
+	proto::signal<int()> moved(std::move(signal));
+	++it;
+	ASSERT_EQ(*it, 2);
+	++it;
+	ASSERT_EQ(*it, 3);
+
+	// ... and ends when it is destroyed
+	auto orphaned_results = std::make_unique<proto::signal<int()>>(std::move(moved))->results();
+	ASSERT_EQ(orphaned_results.begin(), orphaned_results.end());
+}
+
+TEST(SignalTests, SignalEmissionReentrancyTests) {
+	proto::signal<void()> signal;
+	std::vector<int> invoked;
+	proto::connection conn0;
+	proto::connection conn1;
+	proto::connection conn2;
+	conn0 = signal.connect([&]() { invoked.push_back(0); conn1.close(); conn0.close(); });
+	conn1 = signal.connect([&]() { invoked.push_back(1); });
+	conn2 = signal.connect([&]() { invoked.push_back(2); signal.connect([&]() { invoked.push_back(3); }); });
+
+	signal();
+	ASSERT_EQ(invoked, std::vector<int>({ 0, 2 }));
+	ASSERT_EQ(signal.size(), 2);
+
+	invoked.clear();
+	signal();
+	ASSERT_EQ(invoked, std::vector<int>({ 2, 3 }));
+}
+
+TEST(SignalTests, SignalSlotLifetimeReentrancyTests) {
+	// a running slot keeps its captures while it disconnects itself and
+	// while connections grow the slot storage
+	proto::signal<void()> signal;
+	std::vector<int> invoked;
+	proto::connection conn;
+	std::string name(64, 'x');
+	conn = signal.connect([&, name]() {
+		conn.close();
+		for (int i = 0; i < 100; ++i)
+			signal.connect([] {});
+		invoked.push_back(static_cast<int>(name.size()));
+	});
+
+	signal();
+	ASSERT_EQ(invoked, std::vector<int>({ 64 }));
+	ASSERT_EQ(signal.size(), 100);
+}
+
+int TripleFunction(int x) { return 3 * x; }
+
+TEST(SignalTests, SignalFunctionSlotTests) {
+	// free functions and captureless lambdas are stored as function pointers
+	// and can be mixed freely with other callables
+	proto::signal<int(int)> signal;
+	int offset = 1;
+	proto::connection conn0 = signal.connect(TripleFunction);
+	proto::connection conn1 = signal.connect([](int x) { return 2 * x; });
+	proto::connection conn2 = signal.connect([offset](int x) { return x + offset; });
+	proto::connection conn3 = signal.connect(&TripleFunction);
+	ASSERT_EQ(signal.size(), 4);
+
+	std::vector<int> values;
+	signal.collect(std::back_inserter(values), 2);
+	ASSERT_EQ(values, std::vector<int>({ 6, 4, 3, 6 }));
+
+	// function slots survive the compaction of disconnected slots
+	conn0.close();
+	conn2.close();
+	for (int i = 0; i < 16; ++i)
+		signal.connect(TripleFunction);
+	values.clear();
+	signal.collect(std::back_inserter(values), 1);
+	ASSERT_EQ(values.size(), 18);
+	ASSERT_EQ(values[0], 2);
+	ASSERT_EQ(values[1], 3);
+
+	// a null function pointer connects an empty slot, as before
+	int(*null_function)(int) = nullptr;
+	proto::signal<int(int)> null_signal;
+	ASSERT_TRUE(null_signal.connect(null_function));
+	ASSERT_THROW(null_signal(0), std::bad_function_call);
+}
+
+TEST(SignalTests, SmallSignalTests) {
+	// the first N slots live inside the signal, further slots spill over
+	// into heap storage
+	std::vector<int> invoked;
+	proto::small_signal<void(), 2> signal;
+	proto::connection conn0 = signal.connect([&]() { invoked.push_back(0); });
+	signal.connect([&]() { invoked.push_back(1); });
+	signal();
+	ASSERT_EQ(invoked, std::vector<int>({ 0, 1 }));
+
+	signal.connect([&]() { invoked.push_back(2); });
+	conn0.close();
+	invoked.clear();
+	signal();
+	ASSERT_EQ(invoked, std::vector<int>({ 1, 2 }));
+
+	// inline slots move along with the signal
+	proto::small_signal<void(), 2> small;
+	std::string name(64, 'x');
+	proto::connection conn1 = small.connect([&, name]() { invoked.push_back(static_cast<int>(name.size())); });
+	proto::small_signal<void(), 2> moved(std::move(small));
+	invoked.clear();
+	moved();
+	ASSERT_EQ(invoked, std::vector<int>({ 64 }));
+
+	moved.swap(signal);
+	invoked.clear();
+	signal();
+	moved();
+	ASSERT_EQ(invoked, std::vector<int>({ 64, 1, 2 }));
+
+	conn1.close();
+	ASSERT_TRUE(signal.empty());
+}
+
+TEST(SignalTests, SignalEmplaceConnectTests) {
+	// callables are forwarded into the slot storage without copies
+	int sum = 0;
+	proto::signal<void(int)> signal;
+	signal.connect(CountingSlot(sum));
+	CountingSlot slot(sum);
+	signal.connect(slot);
+	ASSERT_EQ(CountingSlot::copies, 1);
+	CountingSlot::copies = 0;
+	signal.emplace_connect<CountingSlot>(sum);
+	signal(1);
+	ASSERT_EQ(sum, 3);
+	ASSERT_EQ(CountingSlot::copies, 0);
+
+	// concurrent signals construct the callable in its final place
+	proto::basic_signal<void(int), proto::spin_locked> concurrent;
+	CountingSlot::moves = 0;
+	concurrent.emplace_connect<CountingSlot>(sum);
+	concurrent(1);
+	ASSERT_EQ(sum, 4);
+	ASSERT_EQ(CountingSlot::moves, 0);
+	ASSERT_EQ(CountingSlot::copies, 0);
+
+	// callables that cannot be copied or moved
+	proto::basic_signal<int(int), proto::spin_locked> pinned;
+	proto::connection conn = pinned.emplace_connect<PinnedSlot>(std::make_unique<int>(3));
+	std::vector<int> values;
+	pinned.collect(std::back_inserter(values), 2);
+	ASSERT_EQ(values, std::vector<int>({ 6 }));
+	conn.close();
+	ASSERT_TRUE(pinned.empty());
+}
+
+struct ValueReceiver : proto::receiver {
+	int doubled(int x) { sum += x; return 2 * x; }
+	int tripled(int x) const { return 3 * x; }
+
+	int sum = 0;
+};
+
+TEST(SignalTests, SignalDiscardedResultTests) {
+	// void signals accept slots that return a value and drop it
+	int sum = 0;
+	proto::signal<void(int)> signal;
+	signal.connect(TripleFunction);
+	signal.connect(&TripleFunction);
+	signal.connect([](int x) { return 2 * x; });
+	signal.connect([&sum](int x) { sum += x; return sum; });
+	ValueReceiver receiver;
+	signal.connect(&receiver, &ValueReceiver::doubled);
+	signal.connect(&receiver, &ValueReceiver::tripled);
+	ASSERT_EQ(signal.size(), 6);
+	signal(2);
+	ASSERT_EQ(sum, 2);
+	ASSERT_EQ(receiver.sum, 2);
+
+	proto::fixed_signal<void(int), 2> fixed;
+	fixed.connect(TripleFunction);
+	fixed.connect([&sum](int x) { sum += x; return sum; });
+	fixed(3);
+	ASSERT_EQ(sum, 5);
+}
+
+TEST(SignalTests, SignalCapacityTests) {
+	// reserved slots do not move as further slots are connected
+	struct address_slot {
+		void operator()(std::vector<const void*>& addresses) const { addresses.push_back(this); }
+	};
+
+	proto::signal<void(std::vector<const void*>&)> signal;
+	signal.reserve(64);
+	signal.connect(address_slot());
+	std::vector<const void*> before;
+	signal(before);
+
+	std::vector<address_slot> slots(63);
+	std::vector<proto::connection> conns = signal.connect_range(slots.begin(), slots.end());
+	ASSERT_EQ(conns.size(), 63);
+	std::vector<const void*> after;
+	signal(after);
+	ASSERT_EQ(after.size(), 64);
+	ASSERT_EQ(after.front(), before.front());
+
+	// reserving mid emission leaves the running slots in place
+	proto::signal<void()> reentrant;
+	int count = 0;
+	reentrant.connect([&]() { reentrant.reserve(1024); ++count; });
+	reentrant();
+	ASSERT_EQ(count, 1);
+
+	// shrinking drops the disconnected slots and keeps the others working
+	for (size_t i = 0; i < conns.size(); i += 2)
+		conns[i].close();
+	signal.shrink_to_fit();
+	after.clear();
+	signal(after);
+	ASSERT_EQ(after.size(), 32);
+
+	// small signals move their slots back inline
+	proto::small_signal<void(std::vector<const void*>&), 4> small;
+	std::vector<proto::connection> small_conns = small.connect_range(slots.begin(), slots.begin() + 8);
+	for (size_t i = 2; i < small_conns.size(); ++i)
+		small_conns[i].close();
+	small.shrink_to_fit();
+	proto::small_signal<void(std::vector<const void*>&), 4> moved(std::move(small));
+	after.clear();
+	moved(after);
+	ASSERT_EQ(after.size(), 2);
+	ASSERT_TRUE(small_conns[0]);
+}
+
+TEST(SignalTests, PagedSignalTests) {
+	// slots stay in place while pages are added
+	struct address_slot {
+		void operator()(std::vector<const void*>& addresses) const { addresses.push_back(this); }
+	};
+
+	proto::paged_signal<void(std::vector<const void*>&), 4> signal;
+	std::vector<proto::connection> conns;
+	for (int i = 0; i < 10; ++i)
+		conns.push_back(signal.connect(address_slot()));
+	std::vector<const void*> before;
+	signal(before);
+	for (int i = 0; i < 30; ++i)
+		conns.push_back(signal.connect(address_slot()));
+	std::vector<const void*> after;
+	signal(after);
+	ASSERT_EQ(after.size(), 40);
+	ASSERT_TRUE(std::equal(before.begin(), before.end(), after.begin()));
+
+	// emptied pages are freed without disturbing the slots around them
+	for (size_t i = 4; i < 12; ++i)
+		conns[i].close();
+	conns[1].close();
+	ASSERT_EQ(signal.size(), 31);
+	ASSERT_FALSE(conns[5]);
+	ASSERT_TRUE(conns[12]);
+	after.clear();
+	signal(after);
+	ASSERT_EQ(after.size(), 31);
+	ASSERT_EQ(after[0], before[0]);
+	ASSERT_EQ(after[1], before[2]);
+
+	// slots disconnected and connected mid emission
+	std::vector<int> invoked;
+	proto::paged_signal<void(), 2> reentrant;
+	proto::connection conn1;
+	reentrant.connect([&]() { 
+		invoked.push_back(0);
+		conn1.close();
+		reentrant.connect([&]() { invoked.push_back(2); });
+	});
+	conn1 = reentrant.connect([&]() { invoked.push_back(1); });
+	reentrant();
+	ASSERT_EQ(invoked, std::vector<int>({ 0 }));
+	invoked.clear();
+	reentrant();
+	ASSERT_EQ(invoked, std::vector<int>({ 0, 2 }));
+	ASSERT_EQ(reentrant.size(), 3);
+
+	reentrant.clear();
+	reentrant.shrink_to_fit();
+	ASSERT_TRUE(reentrant.empty());
+	reentrant.connect([&]() { invoked.push_back(3); });
+	invoked.clear();
+	reentrant();
+	ASSERT_EQ(invoked, std::vector<int>({ 3 }));
+}
+
+TEST(SignalTests, SignalBufferCollectionTests) {
+	proto::signal<int(int)> signal;
+	int num_invocations = 0;
+	for (int i = 1; i <= 4; ++i)
+		signal.connect([&, i](int x) { ++num_invocations; return x * i; });
+
+	int buffer[8] = {};
+	ASSERT_EQ(signal.collect_into(std::begin(buffer), std::end(buffer), 1), 4);
+	ASSERT_EQ(std::accumulate(buffer, buffer + 4, 0), 10);
+	ASSERT_EQ(num_invocations, 4);
+
+	// Slots that do not fit into the buffer are not invoked
+	std::array<int, 2> small_buffer = {};
+	ASSERT_EQ(signal.collect_into(small_buffer.begin(), small_buffer.end(), 2), 2);
+	ASSERT_EQ(small_buffer[0], 2);
+	ASSERT_EQ(small_buffer[1], 4);
+	ASSERT_EQ(num_invocations, 6);
+
+	ASSERT_EQ(signal.collect_into(small_buffer.begin(), small_buffer.begin(), 2), 0);
+	ASSERT_EQ(num_invocations, 6);
+}
+
+TEST(SignalTests, SignalLazyEmissionTests) {
+	proto::signal<void(const std::string&, int)> signal;
+	int num_payloads = 0;
+	auto factory = [&] {
+		++num_payloads;
+		return std::make_tuple(std::string("event ") + std::to_string(num_payloads), num_payloads);
+	};
+
+	// Without slots the payload is never made
+	signal.emit_lazy(factory);
+	ASSERT_EQ(num_payloads, 0);
+	proto::connection conn = signal.connect([](const std::string&, int) {});
+	conn.close();
+	signal.emit_lazy(factory);
+	ASSERT_EQ(num_payloads, 0);
+
+	// It is made once and shared by every slot
+	std::vector<const std::string*> received;
+	for (int i = 0; i < 3; ++i)
+		signal.connect([&](const std::string& text, int n) {
+			ASSERT_EQ(text, "event 1");
+			ASSERT_EQ(n, 1);
+			received.push_back(&text);
+		});
+	signal.emit_lazy(factory);
+	ASSERT_EQ(num_payloads, 1);
+	ASSERT_EQ(received.size(), 3);
+	ASSERT_EQ(received[0], received[1]);
+	ASSERT_EQ(received[1], received[2]);
+
+	// Signals of one parameter take the argument itself
+	proto::signal<int(int)> single;
+	single.connect([](int x) { return x; });
+	int num_values = 0;
+	single.emit_lazy([&] { return ++num_values; });
+	ASSERT_EQ(num_values, 1);
+
+	// even if the argument is a tuple or a pair
+	proto::signal<void(const std::tuple<int, int>&)> tuple_signal;
+	std::tuple<int, int> received_tuple;
+	tuple_signal.connect([&](const std::tuple<int, int>& value) { received_tuple = value; });
+	tuple_signal.emit_lazy([] { return std::make_tuple(1, 2); });
+	ASSERT_EQ(received_tuple, std::make_tuple(1, 2));
+	proto::signal<void(std::pair<int, int>)> pair_signal;
+	std::pair<int, int> received_pair;
+	pair_signal.connect([&](std::pair<int, int> value) { received_pair = value; });
+	pair_signal.emit_lazy([] { return std::make_pair(3, 4); });
+	ASSERT_EQ(received_pair, std::make_pair(3, 4));
+}
+
+struct MaskedReceiver : proto::receiver {
+	void on_event(int x) { sum += x; }
+	void on_event_const(int x) const { *total += x; }
+
+	int sum = 0;
+	int* total = nullptr;
+};
+
+TEST(SignalTests, SignalMaskedEmissionTests) {
+	proto::signal<void(int)> signal;
+	int total = 0;
+	MaskedReceiver receiver;
+	receiver.total = &total;
+	signal.connect(&receiver, &MaskedReceiver::on_event, 0b01);
+	signal.connect(&receiver, &MaskedReceiver::on_event_const, 0b10);
+
+	signal.emit_masked(0b01, 1);
+	ASSERT_EQ(receiver.sum, 1);
+	ASSERT_EQ(total, 0);
+	signal.emit_masked(0b10, 1);
+	ASSERT_EQ(receiver.sum, 1);
+	ASSERT_EQ(total, 1);
+
+	// slots connected mid emission wait for the next one
+	int num_nested = 0;
+	signal.connect([&](int) { signal.connect([&](int) { ++num_nested; }, 0b100); }, 0b100);
+	signal.emit_masked(0b100, 1);
+	ASSERT_EQ(num_nested, 0);
+	signal.emit_masked(0b100, 1);
+	ASSERT_EQ(num_nested, 1);
+	ASSERT_EQ(receiver.num_connections(), 2);
+}
+
+TEST(SignalTests, SignalSmallCollectionTests) {
+	proto::signal<int()> signal;
+	signal.connect([]() { return 1; });
+	signal.connect([]() { return 2; });
+
+	auto values = signal.collect_small<4>();
+	ASSERT_TRUE(values.is_inline());
+	ASSERT_EQ(values.size(), 2);
+	ASSERT_EQ(values[0], 1);
+	ASSERT_EQ(values[1], 2);
+
+	signal.connect([]() { return 3; });
+	auto spilled = signal.collect_small<2>();
+	ASSERT_FALSE(spilled.is_inline());
+	ASSERT_EQ(std::accumulate(spilled.begin(), spilled.end(), 0), 6);
+
+	auto moved(std::move(values));
+	ASSERT_TRUE(values.empty());
+	ASSERT_EQ(moved.size(), 2);
+
+	proto::signal<std::string()> string_signal;
+	string_signal.connect([]() { return std::string(64, 'a'); });
+	auto strings = string_signal.collect_small<1>();
+	ASSERT_TRUE(strings.is_inline());
+	ASSERT_EQ(strings.front().size(), 64);
+	auto copied = strings;
+	ASSERT_EQ(copied.front(), strings.front());
+}
+
+TEST(SignalTests, SignalPropagateExceptionsTests) {
+	proto::signal<void(int)> signal;
+	std::vector<int> invoked;
+	signal.connect([&](int x) { invoked.push_back(x); });
+	signal.connect([&](int) { throw std::runtime_error("slot"); });
+	signal.connect([&](int x) { invoked.push_back(x * 2); });
+
+	// The remaining slots are skipped, but the signal stays usable
+	ASSERT_THROW(signal(1), std::runtime_error);
+	ASSERT_EQ(invoked, std::vector<int>({ 1 }));
+	ASSERT_EQ(signal.size(), 3);
+	ASSERT_THROW(signal(2), std::runtime_error);
+	ASSERT_EQ(invoked, std::vector<int>({ 1, 2 }));
+}
+
+TEST(SignalTests, SignalIsolateExceptionsTests) {
+	proto::signal<int(int), proto::isolate_exceptions> signal;
+	signal.connect([](int x) { return x; });
+	signal.connect([](int) -> int { throw std::runtime_error("first"); });
+	signal.connect([](int x) { return x * 2; });
+	signal.connect([](int) -> int { throw std::logic_error("second"); });
+
+	std::vector<int> values;
+	try {
+		signal.collect(std::back_inserter(values), 1);
+		FAIL();
+	}
+	catch (const proto::emission_error& error) {
+		ASSERT_EQ(error.exceptions().size(), 2);
+		ASSERT_THROW(std::rethrow_exception(error.exceptions()[0]), std::runtime_error);
+		ASSERT_THROW(std::rethrow_exception(error.exceptions()[1]), std::logic_error);
+	}
+	// Every slot that did not throw contributed its value
+	ASSERT_EQ(values, std::vector<int>({ 1, 2 }));
+
+	int buffer[4] = {};
+	ASSERT_THROW(signal.collect_into(std::begin(buffer), std::end(buffer), 2), proto::emission_error);
+	ASSERT_EQ(buffer[0], 2);
+	ASSERT_EQ(buffer[1], 4);
+
+	// Ranges skip slots that throw and raise their exceptions once they end
+	auto results = signal.results(3);
+	auto it = results.begin();
+	ASSERT_EQ(*it, 3);
+	++it;
+	ASSERT_EQ(*it, 6);
+	ASSERT_THROW(++it, proto::emission_error);
+	ASSERT_EQ(it, results.end());
+
+	int sum = 0;
+	proto::signal<void(int), proto::isolate_exceptions> void_signal;
+	void_signal.connect([&](int x) { sum += x; });
+	ASSERT_NO_THROW(void_signal(1));
+	void_signal.connect([&](int x) { throw x; });
+	void_signal.connect([&](int x) { sum += x; });
+	ASSERT_THROW(void_signal(1), proto::emission_error);
+	ASSERT_EQ(sum, 3);
+}
+
+TEST(SignalTests, SignalNothrowEmissionTests) {
+	proto::signal<void(int)> signal;
+	proto::signal<void(int) noexcept> nothrow_signal;
+	proto::signal<void(int), proto::terminate_on_exception> terminate_signal;
+	proto::signal<int(int) noexcept> nothrow_collect_signal;
+
+	static_assert(!noexcept(signal.emit(0)));
+	static_assert(noexcept(nothrow_signal.emit(0)));
+	static_assert(noexcept(terminate_signal.emit(0)));
+	static_assert(noexcept(nothrow_collect_signal.collect(static_cast<int*>(nullptr), 0)));
+
+	int sum = 0;
+	nothrow_signal.connect([&](int x) noexcept { sum += x; });
+	nothrow_signal(2);
+	nothrow_collect_signal.connect([](int x) noexcept { return x; });
+	std::vector<int> values;
+	nothrow_collect_signal.collect(std::back_inserter(values), 3);
+	ASSERT_EQ(sum + values.front(), 5);
+
+	terminate_signal.connect([](int) { throw std::runtime_error("slot"); });
+	ASSERT_DEATH(terminate_signal(1), "");
+}
+
 TEST(SignalTests, ConnectionConstructionTests) {
 	proto::signal<void()> signal;
 	proto::connection conn = signal.connect([]() {});
@@ -0,0 +1,478 @@
+#include <gtest/gtest.h>
+#include <proto/proto.hpp>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <vector>
+
+template <class ThreadingPolicy>
+class ThreadingTests : public ::testing::Test {};
+
+using ThreadingPolicies = ::testing::Types<
+	proto::single_threaded,
+	proto::inline_single_threaded<2>,
+	proto::paged_single_threaded<2>,
+	proto::spin_locked,
+	proto::shared_locked,
+	proto::rcu_snapshots,
+	proto::numa_replicated<proto::rcu_snapshots>,
+	proto::numa_replicated<proto::spin_locked>>;
+
+TYPED_TEST_SUITE(ThreadingTests, ThreadingPolicies);
+
+TYPED_TEST(ThreadingTests, ConnectionTests) {
+	proto::basic_signal<void(int), TypeParam> signal;
+	ASSERT_TRUE(signal.empty());
+
+	int sum = 0;
+	proto::connection conn0 = signal.connect([&](int x) { sum += x; });
+	proto::connection conn1 = signal.connect([&](int x) { sum += 2 * x; });
+	ASSERT_EQ(signal.size(), 2);
+	ASSERT_TRUE(conn0);
+	ASSERT_TRUE(conn1);
+
+	signal(1);
+	ASSERT_EQ(sum, 3);
+
+	conn0.close();
+	ASSERT_FALSE(conn0);
+	ASSERT_EQ(signal.size(), 1);
+	signal(1);
+	ASSERT_EQ(sum, 5);
+
+	signal.clear();
+	ASSERT_FALSE(conn1);
+	ASSERT_TRUE(signal.empty());
+}
+
+void IncrementFunction(int& x) { ++x; }
+
+TYPED_TEST(ThreadingTests, FunctionSlotTests) {
+	proto::basic_signal<void(int&), TypeParam> signal;
+	proto::connection conn0 = signal.connect(IncrementFunction);
+	proto::connection conn1 = signal.connect([](int& x) { x += 10; });
+	proto::connection conn2 = signal.connect(IncrementFunction);
+	ASSERT_EQ(signal.size(), 3);
+
+	int count = 0;
+	signal(count);
+	ASSERT_EQ(count, 12);
+
+	conn0.close();
+	ASSERT_FALSE(conn0);
+	signal(count);
+	ASSERT_EQ(count, 23);
+}
+
+TYPED_TEST(ThreadingTests, LazyEmissionTests) {
+	proto::basic_signal<void(int&), TypeParam> signal;
+	int num_payloads = 0;
+	auto factory = [&] { ++num_payloads; return 0; };
+	signal.emit_lazy(factory);
+	ASSERT_EQ(num_payloads, 0);
+
+	// the slots share one payload, so each sees the increments before it
+	signal.connect(IncrementFunction);
+	signal.connect([](int& x) { ASSERT_EQ(x, 1); x += 10; });
+	signal.connect(IncrementFunction);
+	signal.emit_lazy(factory);
+	ASSERT_EQ(num_payloads, 1);
+
+	signal.clear();
+	signal.emit_lazy(factory);
+	ASSERT_EQ(num_payloads, 1);
+}
+
+TYPED_TEST(ThreadingTests, MaskedEmissionTests) {
+	proto::basic_signal<void(int&), TypeParam> signal;
+	signal.connect([](int& count) { count += 100; });
+
+	// the first slot closes two later slots that share its event
+	std::vector<proto::connection> conns(40);
+	signal.connect([&](int&) { conns[11].close(); conns[19].close(); }, uint64_t(1) << 3);
+	std::vector<int> invoked;
+	for (int i = 0; i < 40; ++i)
+		conns[i] = signal.connect([&invoked, i](int& count) { invoked.push_back(i); ++count; }, uint64_t(1) << (i % 8));
+
+	int count = 0;
+	signal.emit_masked(uint64_t(1) << 3, count);
+	ASSERT_EQ(count, 103);
+	ASSERT_EQ(invoked, std::vector<int>({ 3, 27, 35 }));
+
+	invoked.clear();
+	signal.emit_masked((uint64_t(1) << 0) | (uint64_t(1) << 7), count = 0);
+	ASSERT_EQ(count, 110);
+	ASSERT_EQ(invoked, std::vector<int>({ 0, 7, 8, 15, 16, 23, 24, 31, 32, 39 }));
+
+	signal.emit_masked(0, count = 0);
+	ASSERT_EQ(count, 0);
+
+	// plain emissions ignore the masks
+	signal.emit(count);
+	ASSERT_EQ(count, 138);
+
+	signal.clear();
+	signal.connect([](int& count) { ++count; }, 1);
+	signal.emit_masked(2, count = 0);
+	ASSERT_EQ(count, 0);
+	signal.emit_masked(1, count);
+	ASSERT_EQ(count, 1);
+}
+
+TYPED_TEST(ThreadingTests, CountedSlotTests) {
+	proto::basic_signal<void(int&), TypeParam> signal;
+	std::vector<int> events;
+	signal.on_observed([&]() { events.push_back(1); });
+	signal.on_unobserved([&]() { events.push_back(0); });
+
+	proto::connection once = signal.connect_once([](int& count) { count += 100; });
+	proto::connection twice = signal.connect_n([](int& count) { count += 10; }, 2);
+	ASSERT_FALSE(signal.connect_n([](int& count) { ++count; }, 0));
+	ASSERT_EQ(signal.size(), 2);
+
+	int count = 0;
+	signal(count);
+	ASSERT_EQ(count, 110);
+	ASSERT_FALSE(once);
+	ASSERT_TRUE(twice);
+	signal(count = 0);
+	ASSERT_EQ(count, 10);
+	ASSERT_FALSE(twice);
+	signal(count = 0);
+	ASSERT_EQ(count, 0);
+	ASSERT_TRUE(signal.empty());
+	ASSERT_EQ(events, std::vector<int>({ 1, 0 }));
+
+	// a nested emission from a slot on its last call never reaches it again
+	int num_calls = 0;
+	signal.connect_once([&](int& count) { ++num_calls; signal(count); });
+	signal.connect_n([&](int& count) { ++num_calls; signal(count); }, 2);
+	signal(count);
+	ASSERT_EQ(num_calls, 3);
+	ASSERT_TRUE(signal.empty());
+
+	// counted slots may be closed and masked like any other slot
+	twice = signal.connect_n([](int& count) { ++count; }, 2);
+	twice.close();
+	signal.connect(IncrementFunction, 1);
+	signal(count = 0);
+	signal.emit_masked(2, count);
+	ASSERT_EQ(count, 1);
+
+	// a count of SIZE_MAX connects the slot without a limit
+	signal.clear();
+	proto::connection unlimited = signal.connect_n([](int& count) { ++count; }, std::numeric_limits<size_t>::max());
+	for (int i = 0; i < 3; ++i)
+		signal(count = 0);
+	ASSERT_EQ(count, 1);
+	unlimited.close();
+
+	// counted slots still expire on a signal that was moved from
+	proto::basic_signal<void(int&), TypeParam> moved(std::move(signal));
+	once = signal.connect_once([](int& count) { count += 100; });
+	ASSERT_TRUE(once);
+	signal(count = 0);
+	ASSERT_EQ(count, 100);
+	ASSERT_FALSE(once);
+	signal(count = 0);
+	ASSERT_EQ(count, 0);
+	moved = std::move(signal);
+	signal.connect_n([](int& count) { ++count; }, 2);
+	signal(count = 0);
+	signal(count);
+	signal(count);
+	ASSERT_EQ(count, 2);
+	ASSERT_TRUE(signal.empty());
+
+	proto::basic_signal<int(), TypeParam> producer;
+	producer.connect_once([]() { return 1; });
+	producer.connect([]() { return 2; });
+	std::vector<int> values;
+	producer.collect(std::back_inserter(values));
+	ASSERT_EQ(std::vector<int>(producer.results().begin(), producer.results().end()), std::vector<int>({ 2 }));
+	ASSERT_EQ(values, std::vector<int>({ 1, 2 }));
+}
+
+TYPED_TEST(ThreadingTests, ConnectRangeTests) {
+	proto::basic_signal<void(int&), TypeParam> signal;
+	signal.connect(IncrementFunction);
+	std::vector<std::function<void(int&)>> slots = {
+		IncrementFunction,
+		[](int& x) { x += 10; },
+		[](int& x) { x += 100; } };
+	std::vector<proto::connection> conns = signal.connect_range(slots.begin(), slots.end());
+	ASSERT_EQ(conns.size(), 3);
+	ASSERT_EQ(signal.size(), 4);
+
+	int count = 0;
+	signal(count);
+	ASSERT_EQ(count, 112);
+
+	conns[1].close();
+	ASSERT_TRUE(conns[0]);
+	ASSERT_TRUE(conns[2]);
+	signal.shrink_to_fit();
+	signal(count);
+	ASSERT_EQ(count, 214);
+
+	ASSERT_TRUE(signal.connect_range(slots.end(), slots.end()).empty());
+	ASSERT_EQ(signal.size(), 3);
+}
+
+struct ObservingReceiver : proto::receiver {
+	void on_signal(int&) {}
+};
+
+TYPED_TEST(ThreadingTests, ObservationHookTests) {
+	proto::basic_signal<void(int&), TypeParam> signal;
+	std::vector<int> events;
+	signal.on_observed([&]() { events.push_back(1); });
+	signal.on_unobserved([&]() { events.push_back(0); });
+
+	proto::connection conn0 = signal.connect(IncrementFunction);
+	proto::connection conn1 = signal.connect(IncrementFunction);
+	conn0.close();
+	conn0.close();
+	ASSERT_EQ(events, std::vector<int>({ 1 }));
+	conn1.close();
+	ASSERT_EQ(events, std::vector<int>({ 1, 0 }));
+
+	{
+		ObservingReceiver receiver;
+		signal.connect(&receiver, &ObservingReceiver::on_signal);
+	}
+	ASSERT_EQ(events, std::vector<int>({ 1, 0, 1, 0 }));
+
+	std::vector<std::function<void(int&)>> slots(3, IncrementFunction);
+	signal.connect_range(slots.begin(), slots.end());
+	signal.clear();
+	signal.clear();
+	ASSERT_EQ(events, std::vector<int>({ 1, 0, 1, 0, 1, 0 }));
+
+	// a slot that closes the last connection mid emission
+	proto::connection conn2;
+	conn2 = signal.connect([&](int&) { conn2.close(); });
+	int count = 0;
+	signal(count);
+	ASSERT_EQ(events, std::vector<int>({ 1, 0, 1, 0, 1, 0, 1, 0 }));
+	ASSERT_TRUE(signal.empty());
+
+	// the hooks run without the locks of the signal, so they may check and
+	// close its connections
+	proto::connection conn3;
+	bool valid_in_hook = true;
+	signal.on_observed([&]() { valid_in_hook = conn3.valid(); });
+	signal.on_unobserved([&]() { valid_in_hook = conn3.valid(); conn3.close(); });
+	conn3 = signal.connect(IncrementFunction);
+	conn3.close();
+	ASSERT_FALSE(valid_in_hook);
+	{
+		ObservingReceiver receiver;
+		signal.connect(&receiver, &ObservingReceiver::on_signal);
+		valid_in_hook = true;
+	}
+	ASSERT_FALSE(valid_in_hook);
+}
+
+TYPED_TEST(ThreadingTests, MoveAndSwapTests) {
+	proto::basic_signal<int(), TypeParam> signal0;
+	proto::connection conn = signal0.connect([]() { return 1; });
+	{
+		proto::basic_signal<int(), TypeParam> signal1(std::move(signal0));
+		ASSERT_TRUE(conn);
+		ASSERT_EQ(signal1.size(), 1);
+
+		proto::basic_signal<int(), TypeParam> signal2;
+		signal2.connect([]() { return 2; });
+		signal2.swap(signal1);
+		ASSERT_TRUE(conn);
+		ASSERT_EQ(std::vector<int>(signal2.results().begin(), signal2.results().end()), std::vector<int>({ 1 }));
+		conn.close();
+		ASSERT_TRUE(signal2.empty());
+		ASSERT_EQ(signal1.size(), 1);
+
+		conn = signal1.connect([]() { return 3; });
+		signal0 = std::move(signal1);
+	}
+	ASSERT_TRUE(conn);
+	std::vector<int> values;
+	signal0.collect(std::back_inserter(values));
+	ASSERT_EQ(values, std::vector<int>({ 2, 3 }));
+}
+
+TYPED_TEST(ThreadingTests, ReentrancyTests) {
+	proto::basic_signal<void(), TypeParam> signal;
+	std::vector<int> invoked;
+	proto::connection conn0;
+	proto::connection conn1;
+	conn0 = signal.connect([&]() { invoked.push_back(0); conn1.close(); signal.connect([&]() { invoked.push_back(2); }); });
+	conn1 = signal.connect([&]() { invoked.push_back(1); });
+
+	signal();
+	ASSERT_EQ(invoked, std::vector<int>({ 0 }));
+
+	conn0.close();
+	signal();
+	ASSERT_EQ(invoked, std::vector<int>({ 0, 2 }));
+}
+
+template <class ThreadingPolicy>
+class ConcurrentThreadingTests : public ::testing::Test {};
+
+using ConcurrentThreadingPolicies = ::testing::Types<
+	proto::spin_locked,
+	proto::shared_locked,
+	proto::rcu_snapshots,
+	proto::numa_replicated<proto::rcu_snapshots>,
+	proto::numa_replicated<proto::spin_locked>>;
+
+TYPED_TEST_SUITE(ConcurrentThreadingTests, ConcurrentThreadingPolicies);
+
+TYPED_TEST(ConcurrentThreadingTests, ConcurrentEmissionTests) {
+	proto::basic_signal<void(int), TypeParam> signal;
+	std::atomic<int> sum{ 0 };
+	proto::connection conn = signal.connect([&](int x) { sum += x; });
+
+	constexpr int num_emitters = 4;
+	constexpr int num_emissions = 10000;
+
+	std::atomic<bool> done{ false };
+	std::thread churn([&]() {
+		// connections and disconnections of other slots never affect the one above
+		while (!done) {
+			proto::connection temp = signal.connect([](int) {});
+			temp.close();
+		}
+	});
+
+	std::vector<std::thread> emitters;
+	for (int i = 0; i < num_emitters; ++i)
+		emitters.emplace_back([&]() {
+			for (int j = 0; j < num_emissions; ++j)
+				signal(1);
+		});
+	for (std::thread& emitter : emitters)
+		emitter.join();
+	done = true;
+	churn.join();
+
+	ASSERT_EQ(sum, num_emitters * num_emissions);
+	ASSERT_EQ(signal.size(), 1);
+	conn.close();
+	ASSERT_TRUE(signal.empty());
+}
+
+TYPED_TEST(ConcurrentThreadingTests, ConcurrentDisconnectionTests) {
+	proto::basic_signal<void(), TypeParam> signal;
+	std::atomic<int> count{ 0 };
+	std::vector<proto::connection> conns;
+	for (int i = 0; i < 64; ++i)
+		conns.push_back(signal.connect([&]() { ++count; }));
+
+	std::thread emitter([&]() {
+		for (int i = 0; i < 1000; ++i)
+			signal();
+	});
+	std::thread closer([&]() {
+		for (proto::connection& conn : conns)
+			conn.close();
+	});
+	emitter.join();
+	closer.join();
+
+	ASSERT_TRUE(signal.empty());
+	int before = count;
+	signal();
+	ASSERT_EQ(count, before);
+}
+
+TYPED_TEST(ConcurrentThreadingTests, ConcurrentCountedSlotTests) {
+	proto::basic_signal<void(), TypeParam> signal;
+	std::atomic<int> count{ 0 };
+	for (int i = 0; i < 16; ++i)
+		signal.connect_n([&]() { ++count; }, 100);
+
+	std::vector<std::thread> emitters;
+	for (int i = 0; i < 4; ++i)
+		emitters.emplace_back([&]() {
+			for (int j = 0; j < 1000; ++j)
+				signal();
+		});
+	for (std::thread& emitter : emitters)
+		emitter.join();
+
+	ASSERT_EQ(count, 1600);
+	ASSERT_TRUE(signal.empty());
+}
+
+namespace {
+
+	thread_local size_t fake_node = 0;
+
+	size_t current_fake_node() noexcept {
+		return fake_node;
+	}
+
+	const proto::numa::topology fake_topology{ 4, current_fake_node };
+
+	// installs the fake topology for the lifetime of a test
+	struct FakeTopology {
+		FakeTopology() { proto::numa::override_topology(&fake_topology); }
+		~FakeTopology() { proto::numa::override_topology(nullptr); }
+	};
+
+}
+
+TEST(NumaReplicatedTests, TopologyOverrideTests) {
+	{
+		FakeTopology topology;
+		ASSERT_EQ(proto::numa::num_nodes(), 4);
+		fake_node = 3;
+		ASSERT_EQ(proto::numa::current_node(), 3);
+		fake_node = 0;
+	}
+	ASSERT_GE(proto::numa::num_nodes(), 1);
+	ASSERT_LT(proto::numa::current_node(), proto::numa::num_nodes());
+}
+
+TEST(NumaReplicatedTests, ReplicaUpdateTests) {
+	FakeTopology topology;
+	proto::basic_signal<void(int), proto::numa_replicated<>> signal;
+
+	std::atomic<int> sum{ 0 };
+	proto::connection conn0 = signal.connect([&](int x) { sum += x; });
+	proto::connection conn1 = signal.connect([&](int x) { sum += 10 * x; });
+
+	// every node sees the same slots
+	for (size_t node = 0; node < 4; ++node) {
+		fake_node = node;
+		ASSERT_EQ(signal.size(), 2);
+		signal(1);
+	}
+	ASSERT_EQ(sum, 44);
+
+	fake_node = 2;
+	conn1.close();
+	for (size_t node = 0; node < 4; ++node) {
+		fake_node = node;
+		ASSERT_FALSE(conn1);
+		ASSERT_TRUE(conn0);
+		signal(1);
+	}
+	ASSERT_EQ(sum, 48);
+
+	// emitters on different nodes run concurrently
+	std::vector<std::thread> emitters;
+	for (size_t node = 0; node < 4; ++node)
+		emitters.emplace_back([&, node]() {
+			fake_node = node;
+			for (int i = 0; i < 1000; ++i)
+				signal(1);
+		});
+	for (std::thread& emitter : emitters)
+		emitter.join();
+	ASSERT_EQ(sum, 4048);
+
+	fake_node = 0;
+}
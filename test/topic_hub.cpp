@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <proto/topic_hub.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+	struct Fill {
+		std::string venue;
+		int quantity;
+	};
+
+	struct FillReceiver : proto::receiver {
+		void on_fill(const Fill& fill) { quantity += fill.quantity; }
+
+		int quantity = 0;
+	};
+
+	// the filters that received a fill, sorted as filters are visited in
+	// trie order
+	std::vector<std::string> sorted(std::vector<std::string> filters) {
+		std::sort(filters.begin(), filters.end());
+		return filters;
+	}
+
+}
+
+TEST(TopicHubTests, WildcardTests) {
+	proto::topic_hub<void(const Fill&)> hub;
+	std::vector<std::string> received;
+	std::vector<proto::scoped_connection> conns;
+	for (const char* filter : { "orders.eu.filled", "orders.*.filled", "orders.#", "#", "*.eu.*", "orders.*", "trades.#" })
+		conns.emplace_back(hub.connect(filter, [&received, filter](const Fill&) { received.push_back(filter); }));
+
+	hub.emit("orders.eu.filled", Fill{ "eu", 1 });
+	ASSERT_EQ(sorted(received), sorted({ "orders.eu.filled", "orders.*.filled", "orders.#", "#", "*.eu.*" }));
+
+	received.clear();
+	hub.emit("orders.us", Fill{ "us", 1 });
+	ASSERT_EQ(sorted(received), sorted({ "orders.#", "#", "orders.*" }));
+
+	// # also matches no levels at all, * matches exactly one
+	received.clear();
+	hub.emit("orders", Fill{ "", 1 });
+	ASSERT_EQ(sorted(received), sorted({ "orders.#", "#" }));
+
+	received.clear();
+	hub.emit("orders.eu.filled.late", Fill{ "eu", 1 });
+	ASSERT_EQ(sorted(received), sorted({ "orders.#", "#" }));
+
+	received.clear();
+	hub.emit("quotes.eu.bid", Fill{ "eu", 1 });
+	ASSERT_EQ(sorted(received), sorted({ "#", "*.eu.*" }));
+
+	ASSERT_THROW(hub.connect("orders.#.filled", [](const Fill&) {}), std::invalid_argument);
+	ASSERT_THROW(hub.connect("orders.e*", [](const Fill&) {}), std::invalid_argument);
+}
+
+TEST(TopicHubTests, CacheInvalidationTests) {
+	proto::topic_hub<void(const Fill&)> hub;
+	int quantity = 0;
+	hub.emit("orders.eu.filled", Fill{ "eu", 1 });
+
+	// a cached topic sees filters that gain their first slot
+	proto::connection conn0 = hub.connect("orders.*.filled", [&](const Fill& fill) { quantity += fill.quantity; });
+	hub.emit("orders.eu.filled", Fill{ "eu", 2 });
+	ASSERT_EQ(quantity, 2);
+
+	// and further slots of filters it already routes to
+	proto::connection conn1 = hub.connect("orders.*.filled", [&](const Fill& fill) { quantity += 10 * fill.quantity; });
+	hub.emit("orders.eu.filled", Fill{ "eu", 1 });
+	ASSERT_EQ(quantity, 13);
+
+	conn0.close();
+	conn1.close();
+	hub.emit("orders.eu.filled", Fill{ "eu", 1 });
+	ASSERT_EQ(quantity, 13);
+
+	// receivers disconnect their slots when they are destroyed
+	{
+		FillReceiver receiver;
+		hub.connect("orders.#", &receiver, &FillReceiver::on_fill);
+		hub.emit("orders.eu.filled", Fill{ "eu", 4 });
+		ASSERT_EQ(receiver.quantity, 4);
+		ASSERT_EQ(receiver.num_connections(), 1);
+	}
+	hub.emit("orders.eu.filled", Fill{ "eu", 1 });
+	ASSERT_EQ(quantity, 13);
+
+	// a cache of one topic is emptied whenever another one is resolved
+	proto::topic_hub<void(const Fill&)> small_hub(1);
+	small_hub.connect("orders.*", [&](const Fill& fill) { quantity += fill.quantity; });
+	for (const char* topic : { "orders.eu", "orders.us", "orders.eu" })
+		small_hub.emit(topic, Fill{ "", 1 });
+	ASSERT_EQ(quantity, 16);
+}
+
+TEST(TopicHubTests, ReentrancyTests) {
+	// slots may connect and close slots, which invalidates the route that
+	// is being emitted
+	proto::topic_hub<void(int&)> hub;
+	proto::connection conn;
+	conn = hub.connect("a.b", [&](int& x) {
+		++x;
+		conn.close();
+		hub.connect("a.*", [](int& x) { x += 10; });
+		hub.connect("#", [](int& x) { x += 100; });
+	});
+
+	int count = 0;
+	hub.emit("a.b", count);
+	ASSERT_EQ(count, 1);
+	hub.emit("a.b", count = 0);
+	ASSERT_EQ(count, 110);
+
+	hub.clear();
+	hub.emit("a.b", count = 0);
+	ASSERT_EQ(count, 0);
+}
+
+TEST(TopicHubTests, MoveTests) {
+	proto::topic_hub<void(int&)> hub;
+	proto::connection conn = hub.connect("a.*", [](int& x) { ++x; });
+
+	proto::topic_hub<void(int&)> moved(std::move(hub));
+	int count = 0;
+	moved.emit("a.b", count);
+	ASSERT_EQ(count, 1);
+	hub.emit("a.b", count);
+	ASSERT_EQ(count, 1);
+
+	// the cache of the moved hub is still invalidated by its filters
+	conn.close();
+	moved.emit("a.b", count);
+	ASSERT_EQ(count, 1);
+
+	proto::topic_hub<void(int&)> swapped;
+	swapped.connect("b", [](int& x) { x += 2; });
+	swapped.swap(moved);
+	moved.emit("b", count);
+	ASSERT_EQ(count, 3);
+}
+
+TEST(TopicHubTests, IsolateExceptionsTests) {
+	proto::topic_hub<void(), proto::isolate_exceptions> hub;
+	int num_invocations = 0;
+	hub.connect("a.*", [&]() { ++num_invocations; throw std::runtime_error("a.*"); });
+	hub.connect("a.*", [&]() { ++num_invocations; });
+	hub.connect("a.b", [&]() { ++num_invocations; throw std::runtime_error("a.b"); });
+
+	try {
+		hub.emit("a.b");
+		FAIL();
+	}
+	catch (const proto::emission_error& error) {
+		ASSERT_EQ(error.exceptions().size(), 2);
+	}
+	ASSERT_EQ(num_invocations, 3);
+}